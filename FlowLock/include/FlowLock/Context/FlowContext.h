@@ -5,9 +5,16 @@
 #include <string>
 #include <chrono>
 #include <atomic>
+#include <functional>
 
 namespace adapter {
 
+// What a resumable task's step reports back after processing a chunk.
+enum class StepResult {
+    CONTINUE,
+    DONE
+};
+
 class FlowContext {
 public:
     FlowContext(uint32_t threadId, uint64_t logicalTick, bool enableProfiling = false);
@@ -35,6 +42,23 @@ public:
     bool isCancellationRequested() const;
     
     bool shouldContinue() const;
+    // Also reports cancellation requested on the running task itself.
+    void bindCancellation(const std::atomic<bool>* flag);
+
+    // Set when a more urgent task waits on a PRIORITY tag this task holds. shouldContinue()
+    // turns false and shouldYield() true; yielding then hands the tags over.
+    bool isPreemptionRequested() const;
+    void bindPreemption(const std::atomic<bool>* flag);
+
+    // Gives the worker back once the task function returns: the task is queued again
+    // with its state and tags kept, and runs its function anew when next picked. After a
+    // preemption request the tags are released instead and claimed again on resumption.
+    void yield();
+    bool hasYielded() const;
+
+    // True when more urgent work is waiting, i.e. a good moment to yield.
+    bool shouldYield() const;
+    void setYieldCheck(std::function<bool()> check);
 
 private:
     uint32_t threadId;
@@ -44,6 +68,10 @@ private:
     
     std::optional<std::chrono::steady_clock::time_point> deadlineTime;
     std::atomic<bool> cancellationRequested{false};
+    const std::atomic<bool>* boundCancellation{nullptr};
+    const std::atomic<bool>* boundPreemption{nullptr};
+    bool yieldRequested{false};
+    std::function<bool()> yieldCheck;
 };
 
 } // namespace adapter
\ No newline at end of file
@@ -1,8 +1,16 @@
 #pragma once
 
+#include "FlowLock/Core/TagRegistry.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace adapter {
@@ -14,21 +22,160 @@ public:
     enum class Policy {
         EXCLUSIVE,  // Only one task with a specific tag can run at a time
         SHARED,     // Multiple tasks with the same tag can run concurrently
-        PRIORITY    // Higher priority tasks preempt lower priority ones
+        PRIORITY,   // Higher priority tasks preempt lower priority ones
+        LIMITED     // Up to the tag's limit of tasks can run concurrently
     };
 
     ConflictResolver();
 
-    void setPolicy(const std::string& tag, Policy policy);
+    // The limit only applies to LIMITED and must be at least 1. Returns the waiters the
+    // new policy lets through, already holding their tags. Setting the policy a tag
+    // already has costs one atomic load, so callers may repeat it on every submission.
+    std::vector<std::shared_ptr<FlowTask>> setPolicy(const std::string& tag, Policy policy, uint32_t limit = 1);
+    std::vector<std::shared_ptr<FlowTask>> setPolicy(TagId tag, Policy policy, uint32_t limit = 1);
     Policy getPolicy(const std::string& tag) const;
+    Policy getPolicy(TagId tag) const;
+    uint32_t getLimit(TagId tag) const;
 
     bool canExecute(const std::shared_ptr<FlowTask>& task,
         const std::vector<std::shared_ptr<FlowTask>>& runningTasks) const;
+    // Whether tryAcquire() would claim the tags right now, read from the per-tag
+    // occupancy table without locking: a few atomic loads per tag, however many tasks run.
+    bool canExecute(const std::shared_ptr<FlowTask>& task) const;
+
+    size_t getHolderCount(TagId tag) const;
+    // Highest base priority among the current holders of the tag, 0 if it has none.
+    uint32_t getMaxHolderPriority(TagId tag) const;
+
+    // Claims all of the task's tags at once. On a conflict the task is parked on the
+    // wait list of the blocking tag and false is returned; it is handed back by
+    // release() once it holds every tag. A PRIORITY tag has one holder at a time; a
+    // task parking on it asks lower-priority holders to preempt themselves.
+    // A task's TagAccess overrides the policy: readers share a tag and a writer holds it
+    // alone. Once a writer waits, new readers queue behind it instead of joining.
+    // A tag also covers its subtree: a writer on "db/users" excludes every task under
+    // it, and a reader on it excludes writers under it, while "db/orders" stays free.
+    // Each tag has its own lock, taken in ascending TagId order, so claims on disjoint
+    // tags never contend and overlapping ones cannot deadlock.
+    bool tryAcquire(const std::shared_ptr<FlowTask>& task);
+    std::vector<std::shared_ptr<FlowTask>> release(const std::shared_ptr<FlowTask>& task);
+
+    size_t getWaitingCount() const;
+
+    // Priority inheritance: a task parking on a tag lifts every holder of that tag to
+    // its own priority until the holder releases. The callback is told about each
+    // holder raised, so a queued holder can be moved up.
+    using PriorityBoostCallback = std::function<void(const FlowTask*)>;
+    void setPriorityBoostCallback(PriorityBoostCallback callback);
+
+    // Token bucket per tag: claiming a rate-limited tag takes one of its tokens, which
+    // refill at starts per window up to burst (starts by default). A task short of a
+    // token waits on the tag until refill() is called at the time the refill callback
+    // names. starts == 0 removes the limit.
+    std::vector<std::shared_ptr<FlowTask>> setRateLimit(const std::string& tag, uint32_t starts,
+        std::chrono::milliseconds window, uint32_t burst = 0);
+    std::vector<std::shared_ptr<FlowTask>> setRateLimit(TagId tag, uint32_t starts,
+        std::chrono::milliseconds window, uint32_t burst = 0);
+    // Runs under the tag's lock, so it should only arrange the later call to refill().
+    using RefillCallback = std::function<void(TagId, std::chrono::steady_clock::time_point)>;
+    void setRefillCallback(RefillCallback callback);
+    // Returns the waiters the tag's new tokens let through, already holding their tags.
+    std::vector<std::shared_ptr<FlowTask>> refill(TagId tag);
+
+    // Wait lists favour the highest priority, aged by one level per interval waited
+    // (zero disables aging).
+    void setAgingInterval(std::chrono::milliseconds interval);
 
 private:
-    std::unordered_map<std::string, Policy> policies;
+    struct Waiter {
+        double score;  // Aged priority, fixed when the task first parks
+        std::shared_ptr<FlowTask> task;
+        bool writes = false;  // On the tag it is parked on
+    };
+
+    struct Holder {
+        FlowTask* task;
+        bool writes;
+    };
+
+    // Highest score first, then oldest.
+    struct WaiterOrder {
+        bool operator()(const Waiter& a, const Waiter& b) const;
+    };
+
+    // Published as one atomic value, so readers never see a policy with another one's limit.
+    struct PolicySetting {
+        Policy policy;
+        uint32_t limit;
+
+        bool operator==(const PolicySetting& other) const {
+            return policy == other.policy && limit == other.limit;
+        }
+    };
+
+    // The atomics may be read without locking; the rest is guarded by mutex.
+    struct TagState {
+        std::mutex mutex;
+        std::atomic<PolicySetting> setting;
+        std::atomic<uint32_t> holderCount{ 0 };
+        std::atomic<uint32_t> maxHolderPriority{ 0 };
+        std::atomic<uint32_t> writerCount{ 0 };
+        std::atomic<uint32_t> writersWaiting{ 0 };
+        std::atomic<uint32_t> subtreeHolders{ 0 };  // Holders of tags strictly below this one
+        std::atomic<uint32_t> subtreeWriters{ 0 };
+        std::vector<Holder> holders;
+        std::multiset<Waiter, WaiterOrder> waiters;
+
+        // The token bucket is kept as the time its next token is due, in steady_clock
+        // nanoseconds, so lock-free readers need one load.
+        std::atomic<int64_t> tokenInterval{ 0 };  // 0 when not rate limited
+        std::atomic<int64_t> nextTokenAt{ std::numeric_limits<int64_t>::min() / 2 };
+        int64_t burstAllowance = 0;  // How far ahead of now tokens may be taken
+        bool refillScheduled = false;
+    };
+
+    // Indexed by TagId in fixed-size chunks allocated on first use, so a state never
+    // moves and lock-free readers can follow the pointers. Chunks are listed in blocks,
+    // also allocated on first use, and enough blocks cover every possible TagId.
+    static constexpr size_t kChunkSize = 256;
+    static constexpr size_t kChunksPerBlock = 4096;
+    static constexpr size_t kMaxBlocks =
+        (static_cast<size_t>(std::numeric_limits<TagId>::max()) + 1) / (kChunkSize * kChunksPerBlock);
+    using ChunkBlock = std::array<std::atomic<TagState*>, kChunksPerBlock>;
+
+    // Holds the locks of all of a task's tags for its lifetime.
+    class TagLocks;
+
     Policy defaultPolicy;
 
+    std::mutex chunkMutex;  // Only taken to allocate a chunk or a block
+    std::array<std::atomic<ChunkBlock*>, kMaxBlocks> tagBlocks{};
+    std::vector<std::unique_ptr<ChunkBlock>> ownedBlocks;
+    std::vector<std::unique_ptr<TagState[]>> ownedChunks;
+    std::atomic<size_t> waitingCount{ 0 };
+    std::chrono::steady_clock::time_point epoch{ std::chrono::steady_clock::now() };
+    std::atomic<int64_t> agingIntervalMs{ 0 };
+    std::shared_ptr<const PriorityBoostCallback> boostCallback;  // Accessed with std::atomic_load/store
+    std::shared_ptr<const RefillCallback> refillCallback;  // Likewise
+
+    const TagState* findState(TagId tag) const;
+    TagState& stateOf(TagId tag);
+    bool writes(const FlowTask& task, TagId tag, const TagState& state) const;
+    bool conflicts(bool writer, const TagState& state, bool fresh) const;
+    bool conflictsWithAncestor(bool writer, const TagState& ancestor, bool fresh) const;
+    std::optional<TagId> findConflict(const FlowTask& task, TagId tag, const TagState& state, bool fresh) const;
+    static int64_t nowNanos();
+    void takeToken(TagState& state);
+    void scheduleRefill(TagId tag, TagState& state);
+    // A fresh claim also yields to waiting writers; a waiter being woken does not.
+    std::optional<TagId> findConflict(const FlowTask& task, bool fresh);
+    void hold(const std::shared_ptr<FlowTask>& task);
+    double waiterScore(const FlowTask& task) const;
+    void wakeWaiters(TagId tag, std::vector<std::shared_ptr<FlowTask>>& ready,
+        std::vector<const FlowTask*>& boosted);
+    void park(TagId tag, Waiter waiter, std::vector<const FlowTask*>& boosted);
+    void notifyBoosted(const std::vector<const FlowTask*>& boosted);
+
     bool checkExclusiveConflict(const std::shared_ptr<FlowTask>& task,
         const std::vector<std::shared_ptr<FlowTask>>& runningTasks) const;
 
@@ -6,6 +6,7 @@
 #include <functional>
 #include <future>
 #include <string>
+#include <utility>
 #include <vector>
 #include <chrono>
 
@@ -18,23 +19,50 @@ public:
     FlowBuilder& withPriority(uint32_t priority);
     FlowBuilder& withTag(const std::string& tag);
     FlowBuilder& withTags(const std::vector<std::string>& tags);
+    // Tags the task only reads (run alongside other readers) or writes (run alone),
+    // whatever the tag's policy.
+    FlowBuilder& reads(const std::string& tag);
+    FlowBuilder& writes(const std::string& tag);
+    // Also the task's deadline, counted from submission (after any delay): a task still
+    // queued when it passes is dropped and its future fails.
     FlowBuilder& withTimeout(std::chrono::milliseconds timeout);
+    // Holds the task in the timer wheel for this long before it is queued.
+    FlowBuilder& withDelay(std::chrono::milliseconds delay);
+    // Fair-share key for the FAIR strategy; defaults to the first tag.
+    FlowBuilder& withTenant(const std::string& tenant);
     FlowBuilder& exclusive();
     FlowBuilder& shared();
     FlowBuilder& prioritized();
+    // At most limit tasks on these tags run at once.
+    FlowBuilder& limited(uint32_t limit);
 
     template<typename F>
-    auto run(F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>, FlowContext&>>;
+    auto run(F&& func) -> FlowHandle<std::invoke_result_t<std::decay_t<F>, FlowContext&>>;
 
     template<typename F>
-    auto operator<<(F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>, FlowContext&>>;
+    auto operator<<(F&& func) -> FlowHandle<std::invoke_result_t<std::decay_t<F>, FlowContext&>>;
+
+    // Submits every callable of the range with this builder's settings in one batch and
+    // returns a FlowHandle per task, in range order.
+    template<typename Range>
+    auto runAll(Range&& funcs)
+        -> std::vector<FlowHandle<std::invoke_result_t<std::decay_t<decltype(*std::begin(funcs))>, FlowContext&>>>;
 
 private:
+    template<typename F>
+    auto wrap(F&& func);
+    void applyPolicy();
+    void configure(FlowTask& task) const;
+
     uint32_t priority{ 0 };
     std::vector<std::string> tags;
+    std::vector<std::pair<TagId, TagAccess>> tagAccess;
     std::chrono::milliseconds timeout{ 0 };
+    std::chrono::milliseconds delay{ 0 };
+    std::string tenant;
     bool hasCustomPolicy{ false };
     ConflictResolver::Policy customPolicy;
+    uint32_t customLimit{ 1 };
 };
 
 class ScopedTask {
@@ -53,25 +81,58 @@ private:
 
 
 template<typename F>
-auto FlowBuilder::run(F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>, FlowContext&>> {
-    auto wrappedFunc = [func = std::forward<F>(func), timeout = this->timeout](FlowContext& ctx) mutable {
+auto FlowBuilder::wrap(F&& func) {
+    return [func = std::forward<F>(func), timeout = this->timeout](FlowContext& ctx) mutable {
         if (timeout.count() > 0) {
             ctx.setTimeout(timeout);
         }
         return func(ctx);
     };
+}
 
-    if (hasCustomPolicy && !tags.empty()) {
-        for (const auto& tag : tags) {
-            FlowLockImpl::instance().setPolicy(tag, customPolicy);
-        }
+template<typename F>
+auto FlowBuilder::run(F&& func) -> FlowHandle<std::invoke_result_t<std::decay_t<F>, FlowContext&>> {
+    applyPolicy();
+    auto [task, handle] = FlowLockImpl::instance().createTask(wrap(std::forward<F>(func)), priority, tags);
+    configure(*task);
+    if (delay.count() > 0) {
+        FlowLockImpl::instance().submitTaskAt(std::move(task), std::chrono::steady_clock::now() + delay);
+    } else {
+        FlowLockImpl::instance().submitTask(std::move(task));
     }
+    return std::move(handle);
+}
 
-    return FlowLockImpl::instance().request(std::move(wrappedFunc), priority, tags);
+template<typename Range>
+auto FlowBuilder::runAll(Range&& funcs)
+    -> std::vector<FlowHandle<std::invoke_result_t<std::decay_t<decltype(*std::begin(funcs))>, FlowContext&>>> {
+    std::vector<FlowHandle<std::invoke_result_t<std::decay_t<decltype(*std::begin(funcs))>, FlowContext&>>> handles;
+    std::vector<std::shared_ptr<FlowTask>> tasks;
+
+    applyPolicy();
+    for (auto&& func : funcs) {
+        auto created = [&]() {
+            if constexpr (std::is_lvalue_reference_v<Range>) {
+                return FlowLockImpl::instance().createTask(wrap(func), priority, tags);
+            } else {
+                return FlowLockImpl::instance().createTask(wrap(std::move(func)), priority, tags);
+            }
+        }();
+        configure(*created.first);
+        tasks.push_back(std::move(created.first));
+        handles.push_back(std::move(created.second));
+    }
+
+    if (delay.count() > 0) {
+        FlowLockImpl::instance().submitTasksAt(std::move(tasks), std::chrono::steady_clock::now() + delay);
+    } else {
+        FlowLockImpl::instance().submitTasks(std::move(tasks));
+    }
+    return handles;
 }
 
 template<typename F>
-auto FlowBuilder::operator<<(F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>, FlowContext&>> {
+auto FlowBuilder::operator<<(F&& func) -> FlowHandle<std::invoke_result_t<std::decay_t<F>, FlowContext&>> {
     return run(std::forward<F>(func));
 }
 
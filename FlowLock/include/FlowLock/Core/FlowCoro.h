@@ -0,0 +1,395 @@
+#pragma once
+
+// Coroutine tasks need C++20; with an older standard this header declares nothing.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#define FLOWLOCK_HAS_COROUTINES 1
+
+#include "FlowLock/FlowLockImpl.h"
+#include "FlowLock/Scheduler/FlowTask.h"
+#include "FlowLock/Context/FlowContext.h"
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace adapter {
+
+template<typename T = void>
+class FlowCoro;
+
+namespace detail {
+
+// Resuming a coroutine is just another FlowTask, so it goes through the scheduler, the
+// conflict resolver and the capacity limit like any other work. If the task is dropped
+// instead, onDropped runs in its place.
+inline std::shared_ptr<FlowTask> makeResumeTask(std::coroutine_handle<> handle, uint32_t priority,
+    const std::vector<std::string>& tags, FlowTask::AbandonHandler onDropped) {
+    auto task = std::make_shared<FlowTask>([handle](FlowContext&) { handle.resume(); }, priority);
+    task->setAbandonHandler(std::move(onDropped));
+    for (const auto& tag : tags) {
+        task->addTag(tag);
+    }
+    return task;
+}
+
+// Awaits a plain std::future. It has no completion hook, so a check task polls it from
+// the timer wheel, backing off so a long wait costs few wakeups and never holds a worker.
+template<typename T>
+class FutureAwaiter {
+public:
+    static constexpr std::chrono::milliseconds kFirstPoll{ 1 };
+    static constexpr std::chrono::milliseconds kMaxPoll{ 50 };
+
+    explicit FutureAwaiter(std::future<T>& future) : future(future) {}
+
+    bool await_ready() const {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+    void await_suspend(std::coroutine_handle<> handle) { poll(handle, kFirstPoll); }
+    T await_resume() {
+        // A dropped check task resumes without the result; get() would block.
+        if (error) std::rethrow_exception(error);
+        return future.get();
+    }
+
+private:
+    void poll(std::coroutine_handle<> handle, std::chrono::milliseconds interval) {
+        auto check = std::make_shared<FlowTask>([this, handle, interval](FlowContext&) {
+            if (await_ready()) {
+                handle.resume();
+            } else {
+                poll(handle, std::min(interval * 2, kMaxPoll));
+            }
+        });
+        check->setAbandonHandler([this, handle](std::exception_ptr reason) {
+            error = reason;
+            handle.resume();
+        });
+        FlowLockImpl::instance().submitTaskAt(std::move(check), TimingWheel::Clock::now() + interval);
+    }
+
+    std::future<T>& future;
+    std::exception_ptr error;
+};
+
+// Awaits a FlowHandle from request(), run() or spawn(). The coroutine is resumed by a task
+// submitted once the result is set, so nothing runs while it waits.
+template<typename T>
+class HandleAwaiter {
+public:
+    explicit HandleAwaiter(FlowHandle<T>& handle) : handle(handle), polled(handle) {}
+
+    bool await_ready() const { return polled.await_ready(); }
+    bool await_suspend(std::coroutine_handle<> awaiting) {
+        // Usually runs inside the awaited task, so the resume must not become its child.
+        bool registered = handle.whenReady([this, awaiting]() {
+            FlowLockImpl::instance().submitDetached(makeResumeTask(awaiting, 0, {},
+                [this, awaiting](std::exception_ptr reason) {
+                    error = reason;
+                    awaiting.resume();
+                }));
+        });
+        if (registered) return true;
+        if (await_ready()) return false;
+
+        // A handle built around a future FlowLock did not create cannot notify.
+        polled.await_suspend(awaiting);
+        return true;
+    }
+    T await_resume() {
+        if (error) std::rethrow_exception(error);
+        return polled.await_resume();
+    }
+
+private:
+    FlowHandle<T>& handle;
+    FutureAwaiter<T> polled;
+    std::exception_ptr error;
+};
+
+template<typename T>
+struct CoroResult {
+    std::optional<T> value;
+    void return_value(T result) { value.emplace(std::move(result)); }
+    T take() { return std::move(*value); }
+};
+
+template<>
+struct CoroResult<void> {
+    void return_void() {}
+    void take() {}
+};
+
+template<typename T>
+struct CoroPromise : CoroResult<T> {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    FlowCoro<T> get_return_object();
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<CoroPromise> handle) noexcept {
+            auto next = handle.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() { error = std::current_exception(); }
+
+    template<typename U>
+    FutureAwaiter<U> await_transform(std::future<U>& future) { return FutureAwaiter<U>(future); }
+    template<typename U>
+    FutureAwaiter<U> await_transform(std::future<U>&& future) { return FutureAwaiter<U>(future); }
+    template<typename U>
+    HandleAwaiter<U> await_transform(FlowHandle<U>& handle) { return HandleAwaiter<U>(handle); }
+    template<typename U>
+    HandleAwaiter<U> await_transform(FlowHandle<U>&& handle) { return HandleAwaiter<U>(handle); }
+    template<typename Awaitable>
+    Awaitable&& await_transform(Awaitable&& awaitable) { return std::forward<Awaitable>(awaitable); }
+};
+
+struct DetachedCoro {
+    struct promise_type {
+        DetachedCoro get_return_object() {
+            return { std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+template<typename T>
+DetachedCoro runDetached(FlowCoro<T> coro, std::shared_ptr<std::promise<T>> promise,
+    std::shared_ptr<Completion> completion) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(coro);
+            promise->set_value();
+        } else {
+            promise->set_value(co_await std::move(coro));
+        }
+    } catch (...) {
+        promise->set_exception(std::current_exception());
+    }
+    completion->complete();
+}
+
+} // namespace detail
+
+// A lazily started coroutine. It runs when co_awaited by another FlowCoro or when
+// handed to spawn(), and resumes on a worker after each scheduler awaitable below.
+template<typename T>
+class FlowCoro {
+public:
+    using promise_type = detail::CoroPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit FlowCoro(Handle handle) : handle(handle) {}
+    FlowCoro(FlowCoro&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    FlowCoro& operator=(FlowCoro&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    FlowCoro(const FlowCoro&) = delete;
+    FlowCoro& operator=(const FlowCoro&) = delete;
+    ~FlowCoro() {
+        if (handle) handle.destroy();
+    }
+
+    // Runs the child inline and resumes the awaiting coroutine when it finishes.
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            Handle handle;
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            T await_resume() {
+                if (handle.promise().error) {
+                    std::rethrow_exception(handle.promise().error);
+                }
+                return handle.promise().take();
+            }
+        };
+        return Awaiter{ handle };
+    }
+
+private:
+    Handle handle;
+};
+
+template<typename T>
+FlowCoro<T> detail::CoroPromise<T>::get_return_object() {
+    return FlowCoro<T>(std::coroutine_handle<CoroPromise>::from_promise(*this));
+}
+
+// Suspends and resumes on a worker as a task with this priority and these tags, so the
+// code up to the next suspension point runs while holding them.
+class ScheduleAwaiter {
+public:
+    ScheduleAwaiter(uint32_t priority, std::vector<std::string> tags)
+        : priority(priority), tags(std::move(tags)) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        FlowLockImpl::instance().submitDetached(detail::makeResumeTask(handle, priority, tags,
+            [this, handle](std::exception_ptr reason) {
+                error = reason;
+                handle.resume();
+            }));
+    }
+    void await_resume() const {
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    uint32_t priority;
+    std::vector<std::string> tags;
+    std::exception_ptr error;
+};
+
+inline ScheduleAwaiter schedule(uint32_t priority = 0) {
+    return ScheduleAwaiter(priority, {});
+}
+
+inline ScheduleAwaiter acquireTags(std::vector<std::string> tags, uint32_t priority = 0) {
+    return ScheduleAwaiter(priority, std::move(tags));
+}
+
+// Parks the coroutine in the timer wheel; no worker is held while it sleeps.
+class SleepAwaiter {
+public:
+    SleepAwaiter(TimingWheel::Clock::time_point when, uint32_t priority)
+        : when(when), priority(priority) {}
+
+    bool await_ready() const noexcept { return when <= TimingWheel::Clock::now(); }
+    void await_suspend(std::coroutine_handle<> handle) {
+        FlowLockImpl::instance().submitTaskAt(detail::makeResumeTask(handle, priority, {},
+            [this, handle](std::exception_ptr reason) {
+                error = reason;
+                handle.resume();
+            }), when);
+    }
+    void await_resume() const {
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    TimingWheel::Clock::time_point when;
+    uint32_t priority;
+    std::exception_ptr error;
+};
+
+inline SleepAwaiter sleepUntil(TimingWheel::Clock::time_point when, uint32_t priority = 0) {
+    return SleepAwaiter(when, priority);
+}
+
+inline SleepAwaiter sleepFor(std::chrono::milliseconds delay, uint32_t priority = 0) {
+    return SleepAwaiter(TimingWheel::Clock::now() + delay, priority);
+}
+
+// Runs func as a regular FlowLock task and resumes the coroutine once it has finished,
+// in a separate task that does not hold func's tags.
+template<typename F>
+class AsyncAwaiter {
+public:
+    using Result = std::invoke_result_t<F&, FlowContext&>;
+
+    AsyncAwaiter(F func, uint32_t priority, std::vector<std::string> tags)
+        : func(std::move(func)), priority(priority), tags(std::move(tags)) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        auto resume = [this, handle](std::exception_ptr reason) {
+            if (reason) error = reason;
+            FlowLockImpl::instance().submitDetached(detail::makeResumeTask(handle, priority, {},
+                [this, handle](std::exception_ptr dropped) {
+                    error = dropped;
+                    handle.resume();
+                }));
+        };
+
+        auto task = std::make_shared<FlowTask>([this, resume](FlowContext& context) {
+            std::exception_ptr failure;
+            try {
+                if constexpr (std::is_void_v<Result>) {
+                    func(context);
+                } else {
+                    result.emplace(func(context));
+                }
+            } catch (...) {
+                failure = std::current_exception();
+            }
+            resume(failure);
+        }, priority);
+        task->setAbandonHandler(resume);
+        for (const auto& tag : tags) {
+            task->addTag(tag);
+        }
+        FlowLockImpl::instance().submitTask(std::move(task));
+    }
+    Result await_resume() {
+        if (error) std::rethrow_exception(error);
+        if constexpr (!std::is_void_v<Result>) {
+            return std::move(*result);
+        }
+    }
+
+private:
+    struct Empty {};
+
+    F func;
+    uint32_t priority;
+    std::vector<std::string> tags;
+    std::conditional_t<std::is_void_v<Result>, Empty, std::optional<Result>> result;
+    std::exception_ptr error;
+};
+
+template<typename F>
+AsyncAwaiter<std::decay_t<F>> runAsync(F&& func, uint32_t priority = 0, std::vector<std::string> tags = {}) {
+    return AsyncAwaiter<std::decay_t<F>>(std::forward<F>(func), priority, std::move(tags));
+}
+
+// Starts the coroutine on a worker and returns a handle for its result. Cancelling it
+// only stops a coroutine that has not started: resumptions are detached tasks, so a
+// running coroutine is not cancelled through the handle.
+template<typename T>
+FlowHandle<T> spawn(FlowCoro<T> coro, uint32_t priority = 0, const std::vector<std::string>& tags = {}) {
+    auto promise = std::make_shared<std::promise<T>>();
+    auto completion = std::make_shared<detail::Completion>();
+
+    auto root = detail::runDetached(std::move(coro), promise, completion);
+    auto start = detail::makeResumeTask(root.handle, priority, tags,
+        [handle = root.handle, promise, completion](std::exception_ptr reason) {
+            handle.destroy();
+            promise->set_exception(reason);
+            completion->complete();
+        });
+    FlowHandle<T> result(promise->get_future(), start, completion);
+    FlowLockImpl::instance().submitTask(std::move(start));
+    return result;
+}
+
+} // namespace adapter
+
+#endif
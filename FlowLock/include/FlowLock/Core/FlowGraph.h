@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace adapter {
+    class FlowContext;
+    class FlowTask;
+}
+
+namespace adapter {
+
+// A DAG of tasks. A node is queued only once all of its predecessors have finished,
+// so pipeline stages never hold a worker while waiting on a future.
+class FlowGraph {
+public:
+    using NodeId = size_t;
+    using NodeFunction = std::function<void(FlowContext&)>;
+
+    NodeId addNode(NodeFunction function, uint32_t priority = 0, const std::vector<std::string>& tags = {});
+
+    // 'after' starts only once 'before' has finished.
+    void precede(NodeId before, NodeId after);
+    void dependsOn(NodeId node, const std::vector<NodeId>& predecessors);
+
+    size_t size() const;
+
+    // Queues the root nodes and returns a future that completes once every node has
+    // run. When a node throws or is dropped, the nodes that depend on it are skipped
+    // and the future holds the first error. Throws std::runtime_error if the graph has
+    // a cycle. A graph can be submitted any number of times.
+    std::future<void> submit() const;
+
+private:
+    struct Node {
+        NodeFunction function;
+        uint32_t priority;
+        std::vector<std::string> tags;
+        std::vector<NodeId> successors;
+        size_t predecessorCount{ 0 };
+    };
+
+    struct Run;
+
+    void checkNode(NodeId node) const;
+    bool isAcyclic() const;
+
+    std::vector<Node> nodes;
+};
+
+} // namespace adapter
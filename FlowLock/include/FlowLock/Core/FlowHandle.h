@@ -0,0 +1,77 @@
+#pragma once
+
+#include "FlowLock/Scheduler/FlowTask.h"
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+
+namespace adapter {
+
+namespace detail {
+
+// Set once the promise behind a FlowHandle holds its value or error.
+class Completion {
+public:
+    bool then(std::function<void()> callback) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (done) return false;
+        continuation = std::move(callback);
+        return true;
+    }
+
+    void complete() {
+        std::function<void()> callback;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            callback = std::move(continuation);
+        }
+        if (callback) callback();
+    }
+
+private:
+    std::mutex mutex;
+    bool done = false;
+    std::function<void()> continuation;
+};
+
+} // namespace detail
+
+// The future of a submitted task plus the means to cancel it. It converts to a plain
+// std::future, which keeps existing callers working.
+template<typename R>
+class FlowHandle : public std::future<R> {
+public:
+    FlowHandle() = default;
+    FlowHandle(std::future<R> future, const std::shared_ptr<FlowTask>& task,
+        std::shared_ptr<detail::Completion> completion = nullptr)
+        : std::future<R>(std::move(future)), task(task), completion(std::move(completion)) {}
+
+    // A queued task fails this future at once and is dropped without running; a running
+    // one is asked to stop through FlowContext::shouldContinue(). Either way, tasks it
+    // submitted are cancelled as well.
+    void cancel() {
+        if (auto target = task.lock()) {
+            target->cancel();
+        }
+    }
+
+    bool isCancelled() const {
+        auto target = task.lock();
+        return target && target->isCancelled();
+    }
+
+    // Registers a one-shot callback, run on whichever thread makes the result ready.
+    // Returns false and drops it when the result is already there, or when the handle
+    // wraps a future FlowLock did not create and so cannot be observed.
+    bool whenReady(std::function<void()> callback) {
+        return completion && completion->then(std::move(callback));
+    }
+
+private:
+    std::weak_ptr<FlowTask> task;
+    std::shared_ptr<detail::Completion> completion;
+};
+
+} // namespace adapter
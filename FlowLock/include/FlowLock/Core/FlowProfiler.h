@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FlowLock/Core/TagRegistry.h"
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -42,6 +43,14 @@ namespace adapter {
         void recordTaskFailed(const std::string& tag, uint32_t priority);
         void recordTaskReEnqueued(const std::string& tag, uint32_t priority);
 
+        // Same, for an already interned tag.
+        void recordTaskExecution(TagId tag, uint32_t priority, std::chrono::nanoseconds duration);
+        void recordTaskQueued(TagId tag, uint32_t priority);
+        void recordTaskCancelled(TagId tag, uint32_t priority);
+        void recordTaskTimedOut(TagId tag, uint32_t priority);
+        void recordTaskFailed(TagId tag, uint32_t priority);
+        void recordTaskReEnqueued(TagId tag, uint32_t priority);
+
         std::vector<TaskMetrics> getAllMetrics() const;
         std::optional<TaskMetrics> getMetricsForTag(const std::string& tag) const;
 
@@ -56,8 +65,10 @@ namespace adapter {
     private:
         FlowProfiler();
 
+        TaskMetrics& metricFor(TagId tag);
+
         mutable std::mutex mutex;
-        std::unordered_map<std::string, TaskMetrics> metrics;
+        std::unordered_map<TagId, TaskMetrics> metrics;
         bool enabled{ true };
     };
 
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace adapter {
+
+// Compact identifier for an interned tag. Ids are dense, starting at 0, and stay valid
+// for the lifetime of the process.
+using TagId = uint32_t;
+
+// Interns tag strings once, at submission, so scheduling and conflict checks compare
+// integers instead of strings. Tags form a hierarchy on '/': "db/users/42" lies under
+// "db/users", which lies under "db".
+class TagRegistry {
+public:
+    static constexpr char kSeparator = '/';
+
+    static TagRegistry& instance();
+
+    TagRegistry(const TagRegistry&) = delete;
+    TagRegistry(TagRegistry&&) = delete;
+    TagRegistry& operator=(const TagRegistry&) = delete;
+    TagRegistry& operator=(TagRegistry&&) = delete;
+
+    // Also interns the tag's ancestor paths.
+    TagId intern(const std::string& tag);
+    // Looks a tag up without registering it.
+    std::optional<TagId> find(const std::string& tag) const;
+
+    // The returned reference stays valid; names are never removed.
+    const std::string& name(TagId id) const;
+    std::vector<std::string> names(const std::vector<TagId>& ids) const;
+
+    std::optional<TagId> parent(TagId id) const;
+    // Nearest first; empty for a top-level tag.
+    std::vector<TagId> ancestors(TagId id) const;
+
+    size_t size() const;
+
+private:
+    TagRegistry() = default;
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, TagId> ids;
+    std::deque<std::string> tagNames;  // Indexed by TagId; a deque keeps references stable
+    std::deque<std::optional<TagId>> tagParents;  // Indexed by TagId
+};
+
+} // namespace adapter
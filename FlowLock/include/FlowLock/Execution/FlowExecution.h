@@ -22,16 +22,22 @@ public:
 
     void executeTask(std::shared_ptr<FlowTask> task);
     void setTaskCompletionCallback(TaskCompletionCallback callback);
+    // Receives tasks that called FlowContext::yield() instead of the completion callback.
+    void setTaskYieldedCallback(TaskCompletionCallback callback);
 
     std::vector<std::shared_ptr<FlowTask>> getRunningTasks() const;
+    // Same as getRunningTasks().size() without copying the list.
+    size_t getRunningCount() const;
 
     std::atomic<int>& getExecutionCounter() { return executionCounter; }
 
 private:
     FlowScheduler& scheduler;
     TaskCompletionCallback completionCallback;
+    TaskCompletionCallback yieldedCallback;
     mutable std::mutex runningTasksMutex;
     std::vector<std::shared_ptr<FlowTask>> runningTasks;
+    std::atomic<size_t> runningCount{ 0 };
     std::atomic<int> executionCounter{ 0 };
 
     void notifyTaskCompleted(const std::shared_ptr<FlowTask>& task);
@@ -8,6 +8,8 @@
 
 #include "FlowLock/Core/ConflictResolver.h"
 #include "FlowLock/Core/FlowBuilder.h"
+#include "FlowLock/Core/FlowCoro.h"
+#include "FlowLock/Core/FlowGraph.h"
 #include "FlowLock/Core/FlowProfiler.h"
 #include "FlowLock/Core/FlowSection.h"
 
@@ -29,6 +31,11 @@ public:
         return FlowLockImpl::instance().request(std::forward<F>(func), priority, tags);
     }
     
+    template<typename F>
+    static auto runResumable(F&& step, uint32_t priority = 0, const std::vector<std::string>& tags = {}) {
+        return FlowLockImpl::instance().requestResumable(std::forward<F>(step), priority, tags);
+    }
+    
     template<typename F>
     static auto runExclusive(F&& func, const std::string& tag, uint32_t priority = 0) {
         std::vector<std::string> tags = {tag};
@@ -50,10 +57,42 @@ public:
         return run(std::forward<F>(func), priority, tags);
     }
     
+    template<typename F>
+    static auto tryRun(F&& func, uint32_t priority = 0, const std::vector<std::string>& tags = {}) {
+        return FlowLockImpl::instance().tryRequest(std::forward<F>(func), priority, tags);
+    }
+    
+    template<typename F>
+    static auto runAfter(std::chrono::milliseconds delay, F&& func, uint32_t priority = 0, const std::vector<std::string>& tags = {}) {
+        return FlowLockImpl::instance().runAfter(delay, std::forward<F>(func), priority, tags);
+    }
+    
+    template<typename F>
+    static auto runAt(std::chrono::steady_clock::time_point when, F&& func, uint32_t priority = 0, const std::vector<std::string>& tags = {}) {
+        return FlowLockImpl::instance().runAt(when, std::forward<F>(func), priority, tags);
+    }
+    
+    template<typename F>
+    static TimingWheel::TimerId runEvery(std::chrono::milliseconds period, F&& func, uint32_t priority = 0, const std::vector<std::string>& tags = {}) {
+        return FlowLockImpl::instance().runEvery(period, std::forward<F>(func), priority, tags);
+    }
+    
+    static bool cancelTimer(TimingWheel::TimerId id);
+    
     static bool await(std::chrono::milliseconds timeout = std::chrono::seconds(30));
     static void setThreadPoolSize(size_t size);
-    static void setPolicy(const std::string& tag, ConflictResolver::Policy policy);
+    // limit is the number of concurrent holders a LIMITED tag allows.
+    static void setPolicy(const std::string& tag, ConflictResolver::Policy policy, uint32_t limit = 1);
     static void setDefaultPolicy(ConflictResolver::Policy policy);
+    // At most starts tasks on the tag begin per window (burst may start at once, default
+    // starts); the rest wait without a worker and are woken by the timer thread.
+    static void setRateLimit(const std::string& tag, uint32_t starts, std::chrono::milliseconds window,
+        uint32_t burst = 0);
+    static void setSchedulerStrategy(FlowScheduler::Strategy strategy);
+    static void setFairShareWeight(const std::string& key, uint32_t weight);
+    static void setQueueCapacity(size_t capacity,
+        FlowScheduler::OverflowPolicy policy = FlowScheduler::OverflowPolicy::BLOCK,
+        std::chrono::milliseconds blockTimeout = std::chrono::seconds(1));
     static void shutdown();
     static bool waitForDrain(std::chrono::milliseconds timeout = std::chrono::seconds(60));
     
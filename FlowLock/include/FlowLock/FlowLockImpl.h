@@ -1,11 +1,14 @@
 #pragma once
 
 #include "FlowLock/Core/ConflictResolver.h"
+#include "FlowLock/Core/FlowHandle.h"
 #include "FlowLock/Scheduler/FlowTask.h"
 #include "FlowLock/Scheduler/FlowScheduler.h"
+#include "FlowLock/Scheduler/WorkStealingDeque.h"
 #include "FlowLock/Execution/FlowExecution.h"
 #include "FlowLock/Context/FlowContext.h"
 #include "FlowLock/Utils/ThreadPool.h"
+#include "FlowLock/Utils/TimingWheel.h"
 #include <memory>
 #include <functional>
 #include <future>
@@ -15,6 +18,8 @@
 #include <condition_variable>
 #include <atomic>
 #include <queue>
+#include <thread>
+#include <optional>
 
 namespace adapter {
 
@@ -34,37 +39,141 @@ public:
 
     template<typename F>
     auto request(F&& func, uint32_t priority = 0, const std::vector<std::string>& tags = {})
-        -> std::future<std::invoke_result_t<std::decay_t<F>, FlowContext&>> {
+        -> FlowHandle<std::invoke_result_t<std::decay_t<F>, FlowContext&>> {
+        auto [task, handle] = createTask(std::forward<F>(func), priority, tags);
+        submitTask(std::move(task));
+        return std::move(handle);
+    }
+
+    // Runs step once per dispatch until it returns StepResult::DONE. Between chunks the
+    // worker is given back, but the task keeps its tags and step keeps its state.
+    template<typename F>
+    FlowHandle<void> requestResumable(F&& step, uint32_t priority = 0, const std::vector<std::string>& tags = {}) {
+        return request([step = std::forward<F>(step)](FlowContext& context) mutable {
+            if (step(context) == StepResult::CONTINUE) {
+                context.yield();
+            }
+        }, priority, tags);
+    }
+
+    // Builds every task first, then hands them to the scheduler in one transaction
+    // and wakes at most one worker per task. Each task gets a FlowHandle, as from request().
+    template<typename Range>
+    auto requestBatch(Range&& funcs, uint32_t priority = 0, const std::vector<std::string>& tags = {})
+        -> std::vector<FlowHandle<std::invoke_result_t<std::decay_t<decltype(*std::begin(funcs))>, FlowContext&>>> {
+        std::vector<FlowHandle<std::invoke_result_t<std::decay_t<decltype(*std::begin(funcs))>, FlowContext&>>> handles;
+        std::vector<std::shared_ptr<FlowTask>> tasks;
+
+        for (auto&& func : funcs) {
+            auto created = [&]() {
+                if constexpr (std::is_lvalue_reference_v<Range>) {
+                    return createTask(func, priority, tags);
+                } else {
+                    return createTask(std::move(func), priority, tags);
+                }
+            }();
+            tasks.push_back(std::move(created.first));
+            handles.push_back(std::move(created.second));
+        }
+
+        submitTasks(std::move(tasks));
+        return handles;
+    }
+
+    // Never blocks or sheds: returns nullopt when the scheduler is at capacity.
+    template<typename F>
+    auto tryRequest(F&& func, uint32_t priority = 0, const std::vector<std::string>& tags = {})
+        -> std::optional<FlowHandle<std::invoke_result_t<std::decay_t<F>, FlowContext&>>> {
+        if (!scheduler->tryAdmit()) {
+            return std::nullopt;
+        }
+        auto [task, handle] = createTask(std::forward<F>(func), priority, tags);
+        adoptByCurrentTask(task);
+        pushAdmitted(std::move(task));
+        return std::move(handle);
+    }
+
+    // Delayed and recurring work waits in a timing wheel, not on a worker. Pending
+    // timers do not count as queued work for await().
+    template<typename F>
+    auto runAt(TimingWheel::Clock::time_point when, F&& func, uint32_t priority = 0, const std::vector<std::string>& tags = {})
+        -> FlowHandle<std::invoke_result_t<std::decay_t<F>, FlowContext&>> {
+        auto [task, handle] = createTask(std::forward<F>(func), priority, tags);
+        submitTaskAt(std::move(task), when);
+        return std::move(handle);
+    }
+
+    template<typename F>
+    auto runAfter(std::chrono::milliseconds delay, F&& func, uint32_t priority = 0, const std::vector<std::string>& tags = {})
+        -> FlowHandle<std::invoke_result_t<std::decay_t<F>, FlowContext&>> {
+        return runAt(TimingWheel::Clock::now() + delay, std::forward<F>(func), priority, tags);
+    }
+
+    // Submits a fresh task every period until cancelTimer is called with the returned id.
+    template<typename F>
+    TimingWheel::TimerId runEvery(std::chrono::milliseconds period, F&& func, uint32_t priority = 0, const std::vector<std::string>& tags = {}) {
+        return scheduleTimer(TimingWheel::Clock::now() + period,
+            [this, func = std::forward<F>(func), priority, tags]() {
+                submitTask(createTask(func, priority, tags).first);
+            },
+            period);
+    }
+
+    bool cancelTimer(TimingWheel::TimerId id);
+
+    template<typename F>
+    auto createTask(F&& func, uint32_t priority = 0, const std::vector<std::string>& tags = {})
+        -> std::pair<std::shared_ptr<FlowTask>, FlowHandle<std::invoke_result_t<std::decay_t<F>, FlowContext&>>> {
         using ReturnType = std::invoke_result_t<std::decay_t<F>, FlowContext&>;
         auto taskPromise = std::make_shared<std::promise<ReturnType>>();
+        auto completion = std::make_shared<detail::Completion>();
         auto future = taskPromise->get_future();
         
         auto task = std::make_shared<FlowTask>(
-            [func = std::forward<F>(func), promise = taskPromise](FlowContext& context) mutable {
+            [func = std::forward<F>(func), promise = taskPromise, completion](FlowContext& context) mutable {
                 try {
+                    // A call that yielded is not the last one; its result is ignored.
                     if constexpr (std::is_void_v<ReturnType>) {
                         func(context);
+                        if (context.hasYielded()) return;
                         promise->set_value();
                     } else {
-                        promise->set_value(func(context));
+                        auto result = func(context);
+                        if (context.hasYielded()) return;
+                        promise->set_value(std::move(result));
                     }
                 } catch (...) {
                     promise->set_exception(std::current_exception());
                 }
+                completion->complete();
             },
             priority
         );
+        task->setAbandonHandler([promise = taskPromise, completion](std::exception_ptr reason) {
+            promise->set_exception(reason);
+            completion->complete();
+        });
         
         for (const auto& tag : tags) {
             task->addTag(tag);
         }
         
-        scheduler->enqueueTask(task);
-        scheduleCondVar.notify_one();
-        
-        return future;
+        FlowHandle<ReturnType> handle(std::move(future), task, std::move(completion));
+        return { std::move(task), std::move(handle) };
     }
 
+    // From a worker thread the task lands in that worker's local deque, otherwise in
+    // the global scheduler queue. When the scheduler is at capacity the overflow policy
+    // applies; a rejected task's future holds the error. A task submitted from inside a
+    // running task is cancelled along with it.
+    void submitTask(std::shared_ptr<FlowTask> task);
+    // Like submitTask, but never a child of the running task. Coroutine resumptions use
+    // it: they belong to the coroutine, not to whichever task happened to wake it.
+    void submitDetached(std::shared_ptr<FlowTask> task);
+    void submitTasks(std::vector<std::shared_ptr<FlowTask>> tasks);
+    TimingWheel::TimerId submitTaskAt(std::shared_ptr<FlowTask> task, TimingWheel::Clock::time_point when);
+    TimingWheel::TimerId submitTasksAt(std::vector<std::shared_ptr<FlowTask>> tasks, TimingWheel::Clock::time_point when);
+
     bool await(std::chrono::milliseconds timeout = std::chrono::seconds(5));
     void run();
     void shutdown();
@@ -74,8 +183,14 @@ public:
     using TaskCompletionCallback = std::function<void(const std::shared_ptr<FlowTask>&)>;
     void setTaskCompletionCallback(TaskCompletionCallback callback);
     
-    void setPolicy(const std::string& tag, ConflictResolver::Policy policy);
+    void setPolicy(const std::string& tag, ConflictResolver::Policy policy, uint32_t limit = 1);
+    void setRateLimit(const std::string& tag, uint32_t starts, std::chrono::milliseconds window, uint32_t burst = 0);
     void setDefaultPolicy(ConflictResolver::Policy policy);
+    void setSchedulerStrategy(FlowScheduler::Strategy strategy);
+    void setFairShareWeight(const std::string& key, uint32_t weight);
+    void setQueueCapacity(size_t capacity,
+        FlowScheduler::OverflowPolicy policy = FlowScheduler::OverflowPolicy::BLOCK,
+        std::chrono::milliseconds blockTimeout = std::chrono::seconds(1));
     
     struct Stats {
         size_t queuedTaskCount;
@@ -88,6 +203,8 @@ public:
     Stats stats() const;
     std::string debugDump() const;
     
+    // Waiting tasks age instead of being force-run: a queued or parked task gains one
+    // priority level for every limit x 10 ms it waits. Zero disables aging.
     void setAntiStarvationLimit(size_t limit);
     size_t getAntiStarvationLimit() const;
 
@@ -104,6 +221,23 @@ private:
     std::unique_ptr<ConflictResolver> conflictResolver;
     std::unique_ptr<ThreadPool> threadPool;
 
+    struct Worker {
+        size_t index;
+        WorkStealingDeque deque;
+    };
+    std::vector<std::unique_ptr<Worker>> workers;  // Only touched by workers and while none run
+    // Tasks in all local deques, counted on every push and pop so threads that are not
+    // workers never walk the deques while setThreadPoolSize rebuilds them.
+    std::atomic<size_t> localQueued{ 0 };
+    std::atomic<bool> workersStopping{false};
+    static thread_local Worker* currentWorker;
+
+    TimingWheel timers;
+    std::thread timerThread;
+    std::mutex timerMutex;
+    std::condition_variable timerCondVar;
+    bool timerStopping{false};
+
     std::atomic<bool> stopping{false};
     std::mutex processMutex;
     std::condition_variable scheduleCondVar;
@@ -115,9 +249,30 @@ private:
     std::atomic<size_t> reEnqueuedTaskCount{0};
     
     size_t antiStarvationLimit{10};
+    static constexpr std::chrono::milliseconds kAgingStep{10};
 
     void processNextTask();
     void onTaskCompleted(const std::shared_ptr<FlowTask>& task);
+    void onTaskDropped(const std::shared_ptr<FlowTask>& task);
+    void onTaskYielded(const std::shared_ptr<FlowTask>& task);
+    void notifyIfIdle();
+    void applyAging();
+
+    void workerLoop(Worker& worker);
+    std::shared_ptr<FlowTask> nextTaskFor(Worker& worker);
+    void dispatch(const std::shared_ptr<FlowTask>& task);
+    void handOff(std::vector<std::shared_ptr<FlowTask>> readyTasks);
+    bool admit(const std::shared_ptr<FlowTask>& task);
+    bool reserveSlot(const std::shared_ptr<FlowTask>& task);
+    void adoptByCurrentTask(const std::shared_ptr<FlowTask>& task);
+    void pushAdmitted(std::shared_ptr<FlowTask> task);
+    bool isIdle() const;
+    void stopWorkers();
+    TimingWheel::TimerId scheduleTimer(TimingWheel::Clock::time_point when, TimingWheel::Action action,
+        std::chrono::milliseconds period = std::chrono::milliseconds(0));
+    void timerLoop();
+    void stopTimers();
+    size_t localQueuedCount() const;
 };
 
 } // namespace adapter
\ No newline at end of file
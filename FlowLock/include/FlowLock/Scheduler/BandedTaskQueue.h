@@ -0,0 +1,42 @@
+#pragma once
+
+#include "FlowLock/Scheduler/TaskQueue.h"
+#include "FlowLock/Scheduler/RingTaskQueue.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace adapter {
+
+// Priority bands, each a RingTaskQueue, with an occupancy bitmap so a consumer
+// finds the highest non-empty band without touching the others. Priorities below
+// kExactBands get their own band; larger priorities share logarithmic bands.
+class BandedTaskQueue : public TaskQueue {
+public:
+    static constexpr size_t kBandCount = 64;
+    static constexpr size_t kExactBands = 48;
+
+    explicit BandedTaskQueue(size_t bandCapacity = 1024);
+    ~BandedTaskQueue() override;
+
+    void push(std::shared_ptr<FlowTask> task) override;
+    std::shared_ptr<FlowTask> tryPop() override;
+    size_t size() const override;
+    bool hasPriorityAbove(uint32_t priority) const override;
+    std::shared_ptr<FlowTask> tryPopAbove(const FlowTask& rival) override;
+    std::shared_ptr<FlowTask> popLowestBelow(uint32_t priority) override;
+
+    static size_t bandFor(uint32_t priority);
+
+private:
+    RingTaskQueue& bandAt(size_t index);
+    std::shared_ptr<FlowTask> popHighest(uint64_t allowed);
+
+    size_t bandCapacity;
+    std::array<std::atomic<RingTaskQueue*>, kBandCount> bands;
+    std::atomic<uint64_t> occupancy{ 0 };
+    std::atomic<size_t> totalCount{ 0 };
+};
+
+} // namespace adapter
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "FlowLock/Scheduler/TaskQueue.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+namespace adapter {
+
+// Earliest deadline first. Tasks without a deadline come after every task that has
+// one; priority then submission order break ties.
+class DeadlineTaskQueue : public TaskQueue {
+public:
+    void push(std::shared_ptr<FlowTask> task) override;
+    void pushBulk(std::vector<std::shared_ptr<FlowTask>>& tasks) override;
+    std::shared_ptr<FlowTask> tryPop() override;
+    size_t size() const override;
+    bool hasPriorityAbove(uint32_t priority) const override;
+    std::shared_ptr<FlowTask> tryPopAbove(const FlowTask& rival) override;
+
+private:
+    struct DeadlineComparator {
+        bool operator()(const std::shared_ptr<FlowTask>& a, const std::shared_ptr<FlowTask>& b) const;
+    };
+
+    mutable std::mutex mutex;
+    std::priority_queue<std::shared_ptr<FlowTask>, std::vector<std::shared_ptr<FlowTask>>, DeadlineComparator> tasks;
+    std::atomic<int64_t> topPriority{ -1 };
+
+    void publishTop();
+};
+
+} // namespace adapter
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "FlowLock/Scheduler/TaskQueue.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace adapter {
+
+// Start-time fair queueing. Each flow (a task's tenant, else its first tag) gets a
+// share of dispatches proportional to its weight; FIFO within a flow.
+class FairTaskQueue : public TaskQueue {
+public:
+    void push(std::shared_ptr<FlowTask> task) override;
+    void pushBulk(std::vector<std::shared_ptr<FlowTask>>& tasks) override;
+    std::shared_ptr<FlowTask> tryPop() override;
+    size_t size() const override;
+    bool hasPriorityAbove(uint32_t priority) const override;
+
+    // Applies to tasks enqueued afterwards. Flows default to weight 1.
+    void setWeight(const std::string& key, uint32_t weight);
+
+    static const std::string& flowKey(const FlowTask& task);
+
+private:
+    struct Flow {
+        uint32_t weight = 1;
+        double lastFinish = 0.0;
+        std::deque<std::pair<double, std::shared_ptr<FlowTask>>> tasks;  // Start tag, task
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Flow> flows;
+    std::set<std::pair<double, Flow*>> backlogged;  // Keyed by each flow's head start tag
+    double virtualTime = 0.0;
+    size_t taskCount = 0;
+
+    void pushLocked(std::shared_ptr<FlowTask> task);
+};
+
+} // namespace adapter
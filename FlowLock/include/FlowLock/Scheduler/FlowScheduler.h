@@ -1,16 +1,19 @@
 #pragma once
 
 #include <memory>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <array>
 #include <vector>
 #include <functional>
+#include <chrono>
+#include <string>
 
 namespace adapter {
     class FlowTracer;
     class FlowTask;
+    class TaskQueue;
 }
 
 namespace adapter {
@@ -18,31 +21,105 @@ namespace adapter {
 class FlowScheduler {
 public:
     enum class Strategy {
-        FIFO,
-        PRIORITY
+        FIFO,           // Lock-free ring, submission order, O(1)
+        PRIORITY,
+        PRIORITY_BANDS, // Lock-free priority bands, FIFO within a band
+        DEADLINE,       // Earliest deadline first, priority as tiebreaker
+        FAIR            // Weighted fair share per tenant (or first tag)
     };
 
+    enum class OverflowPolicy {
+        BLOCK,          // Submitter waits for room, up to the block timeout
+        REJECT,         // Newcomer fails right away
+        SHED_LOWEST     // Least urgent queued task is dropped if it ranks below the newcomer
+    };
+
+    using TaskDroppedCallback = std::function<void(const std::shared_ptr<FlowTask>&)>;
+
     FlowScheduler(Strategy strategy = Strategy::PRIORITY);
+    ~FlowScheduler();
 
     void enqueueTask(std::shared_ptr<FlowTask> task);
+    void enqueueTasks(std::vector<std::shared_ptr<FlowTask>> tasks);
     std::shared_ptr<FlowTask> dequeueTask();
+    std::shared_ptr<FlowTask> tryDequeueTask();
+    // Only dequeues a task the active queue ranks above rival; nothing is requeued.
+    std::shared_ptr<FlowTask> tryDequeueTaskAbove(const FlowTask& rival);
     bool hasTasks() const;
+    bool hasTaskAbove(uint32_t priority) const;
+
+    // Parks the calling thread until ready() holds or new work is announced. There is
+    // no timeout: every producer path ends in notifyWorkAvailable.
+    void waitForWork(const std::function<bool()>& ready);
 
+    // Wakes up to taskCount parked consumers, e.g. when work appeared outside the queue.
+    void notifyWorkAvailable(size_t taskCount = 1);
+    void wakeAll();
+
+    // Safe on a live scheduler: queued tasks move to the new strategy's queue, and
+    // producers that raced with the switch move their own task after it.
     void setStrategy(Strategy strategy);
     Strategy getStrategy() const;
 
     size_t getQueueSize() const;
 
+    // Bounds the number of admitted tasks that have not started yet; zero means
+    // unbounded. Admission is separate from enqueueTask so internal re-queues never
+    // count twice.
+    void setCapacity(size_t capacity, OverflowPolicy policy = OverflowPolicy::BLOCK,
+        std::chrono::milliseconds blockTimeout = std::chrono::seconds(1));
+    size_t getCapacity() const;
+
+    // Reserves room for a new task, applying the overflow policy when full. mayBlock
+    // is false for submitters that must not wait (worker threads): BLOCK then admits
+    // over capacity. Returns false when the task is rejected.
+    bool admit(const std::shared_ptr<FlowTask>& task, bool mayBlock = true);
+    bool tryAdmit();
+
+    // Moves a queued task up after its effective priority was raised.
+    void promote(const FlowTask* task);
+    // An admitted task started or was dropped.
+    void releaseAdmission();
+
+    // PRIORITY strategy: a queued task gains one priority level per interval waited.
+    void setAgingInterval(std::chrono::milliseconds interval);
+
+    // Relative share of the FAIR strategy's dispatches for a tenant or tag.
+    void setFairShareWeight(const std::string& key, uint32_t weight);
+
+    // Tasks whose deadline passed while queued are abandoned at dequeue time and
+    // reported here instead of being returned.
+    void setTaskDroppedCallback(TaskDroppedCallback callback);
+
 private:
-    struct TaskComparator {
-        bool operator()(const std::shared_ptr<FlowTask>& a, const std::shared_ptr<FlowTask>& b) const;
-    };
+    static constexpr size_t kStrategyCount = 5;
+
+    TaskQueue& queueFor(Strategy strategy);
+    void pushToActive(std::shared_ptr<FlowTask> task);
+    void drainStale(TaskQueue& stale);
+    std::shared_ptr<FlowTask> popLive();
+    bool dropIfDead(const std::shared_ptr<FlowTask>& task);
+    void dropTask(const std::shared_ptr<FlowTask>& task, const char* reason);
 
     mutable std::mutex queueMutex;
     std::condition_variable condVar;
-    std::priority_queue<std::shared_ptr<FlowTask>, std::vector<std::shared_ptr<FlowTask>>, TaskComparator> taskQueue;
-    Strategy currentStrategy;
-    std::atomic<bool> stopping{ false };
+    // Queues are created on first use and kept until destruction, so a thread still
+    // holding a previously active queue never touches freed memory.
+    std::array<std::unique_ptr<TaskQueue>, kStrategyCount> queues;
+    std::array<std::atomic<TaskQueue*>, kStrategyCount> createdQueues;
+    std::atomic<TaskQueue*> activeQueue{ nullptr };
+    std::atomic<Strategy> currentStrategy;
+    std::atomic<size_t> waitingConsumers{ 0 };
+    std::atomic<uint64_t> wakeEpoch{ 0 };
+    TaskDroppedCallback droppedCallback;
+
+    std::atomic<size_t> capacity{ 0 };
+    std::atomic<OverflowPolicy> overflowPolicy{ OverflowPolicy::BLOCK };
+    std::chrono::milliseconds blockTimeout{ std::chrono::seconds(1) };
+    std::atomic<size_t> admittedCount{ 0 };
+    std::atomic<size_t> blockedSubmitters{ 0 };
+    std::mutex capacityMutex;
+    std::condition_variable capacityCondVar;
 };
 
-} // namespace adapter
\ No newline at end of file
+} // namespace adapter
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FlowLock/Core/TagRegistry.h"
 #include <functional>
 #include <chrono>
 #include <string>
@@ -7,6 +8,8 @@
 #include <memory>
 #include <atomic>
 #include <optional>
+#include <exception>
+#include <mutex>
 
 namespace adapter {
     class FlowContext;
@@ -14,27 +17,88 @@ namespace adapter {
 
 namespace adapter {
 
+// How a task uses one of its tags. Readers of a tag run together, a writer runs alone;
+// DEFAULT follows the tag's policy (EXCLUSIVE and PRIORITY write, SHARED and LIMITED read).
+enum class TagAccess { DEFAULT, READ, WRITE };
+
 class FlowTask {
 public:
     using TaskFunction = std::function<void(FlowContext&)>;
+    using AbandonHandler = std::function<void(std::exception_ptr)>;
 
     FlowTask(TaskFunction function, uint32_t priority = 0,
              std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
 
-    void addTag(const std::string& tag);
+    // Adding a tag again keeps the stronger access of the two.
+    void addTag(const std::string& tag, TagAccess access = TagAccess::DEFAULT);
+    void addTag(TagId tag, TagAccess access = TagAccess::DEFAULT);
     bool hasTag(const std::string& tag) const;
-    const std::vector<std::string>& getTags() const;
+    bool hasTag(TagId tag) const;
+    // Interned ids, in the order added; this is what scheduling works with.
+    const std::vector<TagId>& getTagIds() const;
+    // Tag names, resolved through the TagRegistry.
+    std::vector<std::string> getTags() const;
+    // Ascending ids of the task's own tags.
+    const std::vector<TagId>& getSortedTagIds() const;
+    // The own tags and all their ancestor paths, ascending: the tag states
+    // ConflictResolver locks, in that order, to claim them.
+    const std::vector<TagId>& getSortedLockIds() const;
+    TagAccess getTagAccess(TagId tag) const;
+    // Ancestor paths of one of the task's tags, nearest first.
+    const std::vector<TagId>& getAncestors(TagId tag) const;
+
+    // Maintained by ConflictResolver while the task holds its tags; returns the
+    // previous value.
+    bool setHoldingTags(bool holding);
+    bool isHoldingTags() const;
+
+    void setTenant(const std::string& tenant);
+    const std::string& getTenant() const;
 
     uint32_t getPriority() const;
+    // The priority queues order by: the base one, or a higher one inherited from a task
+    // waiting on a tag this one holds.
+    uint32_t getEffectivePriority() const;
+    // Raises the inherited priority; returns false if it was already at least that high.
+    bool inheritPriority(uint32_t priority);
+    void clearInheritedPriority();
     std::chrono::steady_clock::time_point getTimestamp() const;
+    // When the task last joined the scheduler queue or a tag wait list; aging counts
+    // from here, not from creation, so time spent running or in a timer earns nothing.
+    void markWaiting(std::chrono::steady_clock::time_point since = std::chrono::steady_clock::now());
+    std::chrono::steady_clock::time_point getWaitingSince() const;
 
     void execute(FlowContext& context);
+    // Set once the function has been entered; a yielded task is started but unfinished.
+    bool hasStarted() const;
     
+    // A task that has not started is abandoned right away and dropped when it next
+    // reaches dispatch; a running one sees the request through its FlowContext. Tasks
+    // submitted from inside this one are cancelled with it.
     void cancel();
     bool isCancelled() const;
+
+    // Asks a running task to give up its tags at its next checkpoint because a more
+    // urgent task is waiting on one of them. Cleared once the task has yielded.
+    void requestPreemption();
+    bool isPreemptionRequested() const;
+    void clearPreemption();
+
+    // Links a task submitted while this one runs, cancelling it at once if this one
+    // already is.
+    void adoptChild(const std::shared_ptr<FlowTask>& child);
+    // The task whose function is running on the calling thread, if any.
+    static FlowTask* current();
     
     void setTimeout(std::chrono::milliseconds timeout);
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+    std::optional<std::chrono::steady_clock::time_point> getDeadline() const;
     bool isTimedOut() const;
+
+    // Called instead of execute() when the task is dropped without running, so the
+    // submitter's future still completes.
+    void setAbandonHandler(AbandonHandler handler);
+    void abandon(std::exception_ptr reason);
     
     void incrementReenqueueCount();
     size_t getReenqueueCount() const;
@@ -42,11 +106,27 @@ public:
 private:
     TaskFunction function;
     uint32_t priority;
+    std::atomic<uint32_t> inheritedPriority{0};
     std::chrono::steady_clock::time_point timestamp;
-    std::vector<std::string> tags;
+    std::atomic<std::chrono::steady_clock::time_point> waitingSince;
+    std::vector<TagId> tags;
+    std::vector<TagId> sortedTags;
+    std::vector<TagAccess> sortedAccess;  // Parallel to sortedTags
+    std::vector<std::vector<TagId>> sortedAncestors;  // Parallel to sortedTags
+    std::vector<TagId> lockTags;
+    std::atomic<bool> holdingTags{false};
+    std::string tenant;
+    enum class Lifecycle { PENDING, STARTED, ABANDONED };
+
     std::atomic<bool> cancelled{false};
+    std::atomic<bool> preemptionRequested{false};
+    std::atomic<Lifecycle> lifecycle{Lifecycle::PENDING};
+    std::atomic<bool> abandoned{false};
+    std::mutex childMutex;
+    std::vector<std::weak_ptr<FlowTask>> children;
     std::optional<std::chrono::steady_clock::time_point> deadlineTime;
     std::atomic<size_t> reenqueueCount{0};
+    AbandonHandler abandonHandler;
 };
 
 } // namespace adapter
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "FlowLock/Scheduler/TaskQueue.h"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace adapter {
+
+class PriorityTaskQueue : public TaskQueue {
+public:
+    void push(std::shared_ptr<FlowTask> task) override;
+    void pushBulk(std::vector<std::shared_ptr<FlowTask>>& tasks) override;
+    std::shared_ptr<FlowTask> tryPop() override;
+    size_t size() const override;
+    bool hasPriorityAbove(uint32_t priority) const override;
+    // Compares aged scores, so a starved head counts as more urgent than fresh local work.
+    std::shared_ptr<FlowTask> tryPopAbove(const FlowTask& rival) override;
+    std::shared_ptr<FlowTask> popLowestBelow(uint32_t priority) override;
+    // Linear lookup, then a sift-up; only runs when a waiter boosts a queued holder.
+    void promote(const FlowTask* task) override;
+
+    // A queued task gains one priority level per interval it has waited since it was
+    // last queued; zero keeps strict priority order. Applies to tasks pushed afterwards.
+    void setAgingInterval(std::chrono::milliseconds interval);
+
+private:
+    // The aged priority p + (now - since) / interval orders tasks the same way at
+    // any instant as p - since / interval, so the key is fixed at push time.
+    struct Entry {
+        double score;
+        std::chrono::steady_clock::time_point since;  // Waiting since; breaks ties FIFO
+        uint32_t priority;  // Effective priority counted in priorityCounts
+        std::shared_ptr<FlowTask> task;
+    };
+
+    struct TaskComparator {
+        bool operator()(const Entry& a, const Entry& b) const;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Entry> tasks;  // Max-heap under TaskComparator
+    std::chrono::steady_clock::time_point epoch{ std::chrono::steady_clock::now() };
+    std::chrono::milliseconds agingInterval{ 0 };
+    // Aging can put an old low-priority task at the head, so the highest effective
+    // priority queued is tracked apart from the heap order.
+    std::map<uint32_t, size_t> priorityCounts;
+    std::atomic<int64_t> topPriority{ -1 };  // Published under mutex, read without it
+
+    void publishTop();
+    void pushLocked(std::shared_ptr<FlowTask> task);
+    std::shared_ptr<FlowTask> popHeadLocked();
+    double scoreOf(const FlowTask& task) const;
+    void countPriority(uint32_t priority);
+    void uncountPriority(uint32_t priority);
+};
+
+} // namespace adapter
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "FlowLock/Scheduler/TaskQueue.h"
+#include "FlowLock/Utils/MpmcQueue.h"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace adapter {
+
+// Strict FIFO with O(1) push/pop on a lock-free MPMC ring. When the ring is full, tasks
+// spill into a mutex-guarded overflow; while the overflow holds tasks, producers append
+// there too so order is kept, and consumers refill the ring from it.
+class RingTaskQueue : public TaskQueue {
+public:
+    explicit RingTaskQueue(size_t capacity = 8192);
+
+    void push(std::shared_ptr<FlowTask> task) override;
+    std::shared_ptr<FlowTask> tryPop() override;
+    size_t size() const override;
+    bool hasPriorityAbove(uint32_t priority) const override;
+
+private:
+    std::shared_ptr<FlowTask> popOverflow();
+
+    MpmcQueue<std::shared_ptr<FlowTask>> ring;
+    std::atomic<size_t> count{ 0 };
+
+    std::mutex overflowMutex;
+    std::deque<std::shared_ptr<FlowTask>> overflow;
+    std::atomic<size_t> overflowCount{ 0 };
+};
+
+} // namespace adapter
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace adapter {
+    class FlowTask;
+}
+
+namespace adapter {
+
+// Storage behind a FlowScheduler strategy. Implementations are thread-safe on their own.
+class TaskQueue {
+public:
+    virtual ~TaskQueue() = default;
+
+    virtual void push(std::shared_ptr<FlowTask> task) = 0;
+    virtual void pushBulk(std::vector<std::shared_ptr<FlowTask>>& tasks) {
+        for (auto& task : tasks) {
+            push(std::move(task));
+        }
+    }
+    virtual std::shared_ptr<FlowTask> tryPop() = 0;
+    virtual size_t size() const = 0;
+
+    // Cheap, possibly stale hint used to decide between local and queued work.
+    virtual bool hasPriorityAbove(uint32_t priority) const = 0;
+
+    // Pops the head only if it outranks rival by the key this queue orders on, so a
+    // worker holding local work never takes a task out just to put it back. Queues
+    // whose hasPriorityAbove never reports a task leave it in place.
+    virtual std::shared_ptr<FlowTask> tryPopAbove(const FlowTask&) { return nullptr; }
+
+    // Removes the least urgent task that has not started yet if its priority is below
+    // the given one; used to shed load. Started tasks gave their admission back, so
+    // shedding one frees nothing. Queues without a notion of "least urgent" return nullptr.
+    virtual std::shared_ptr<FlowTask> popLowestBelow(uint32_t) { return nullptr; }
+
+    // Re-ranks a queued task whose effective priority was raised. Queues that cannot
+    // reorder in place ignore it; the task is ranked anew the next time it is pushed.
+    virtual void promote(const FlowTask*) {}
+
+    bool empty() const { return size() == 0; }
+};
+
+} // namespace adapter
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+namespace adapter {
+    class FlowTask;
+}
+
+namespace adapter {
+
+// Per-worker deque. The owning worker pushes and pops at the back (LIFO, cache-warm
+// fork/join children); idle workers steal from the front (oldest work first).
+class WorkStealingDeque {
+public:
+    void pushBack(std::shared_ptr<FlowTask> task);
+    void pushBack(std::vector<std::shared_ptr<FlowTask>>& batch);
+    std::shared_ptr<FlowTask> popBack();
+    std::shared_ptr<FlowTask> stealFront();
+
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+private:
+    mutable std::mutex mutex;
+    std::deque<std::shared_ptr<FlowTask>> tasks;
+    std::atomic<size_t> count{ 0 };
+};
+
+} // namespace adapter
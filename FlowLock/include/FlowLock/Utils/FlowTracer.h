@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FlowLock/Core/TagRegistry.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -32,7 +33,7 @@ struct TraceEvent {
     std::string description;
     std::optional<uint32_t> taskId;
     std::optional<uint32_t> threadId;
-    std::vector<std::string> tags;
+    std::vector<TagId> tags;  // Names via TagRegistry::name()
     uint32_t priority{0};
 };
 
@@ -75,6 +76,13 @@ public:
 private:
     FlowTracer();
 
+    // Task events take the task's interned tag ids as they are.
+    void appendEvent(TraceEvent::Type type, const std::string& description,
+        std::optional<uint32_t> taskId,
+        std::optional<uint32_t> threadId,
+        const std::vector<TagId>& tags,
+        uint32_t priority);
+
     mutable std::mutex mutex;
     std::vector<TraceEvent> events;
     size_t maxEvents;
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace adapter {
+
+    // Hierarchical timing wheel: 4 levels of 256 slots on top of a fixed tick. Insert
+    // and cancel are O(1); an entry is moved at most once per level on its way down.
+    class TimingWheel {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimerId = uint64_t;
+        using Action = std::function<void()>;
+
+        explicit TimingWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(1),
+            Clock::time_point start = Clock::now());
+
+        TimingWheel(const TimingWheel&) = delete;
+        TimingWheel& operator=(const TimingWheel&) = delete;
+
+        // A non-zero period re-arms the timer after each expiry under the same id.
+        TimerId schedule(Clock::time_point when, Action action,
+            std::chrono::milliseconds period = std::chrono::milliseconds(0));
+        bool cancel(TimerId id);
+
+        // Moves the wheel to now and returns the actions that came due; the caller runs
+        // them outside the wheel's lock.
+        std::vector<Action> advance(Clock::time_point now);
+
+        // Earliest point at which advance() may have something to do.
+        std::optional<Clock::time_point> nextWakeup() const;
+
+        size_t size() const;
+
+    private:
+        static constexpr size_t kLevels = 4;
+        static constexpr size_t kSlotBits = 8;
+        static constexpr size_t kSlots = size_t(1) << kSlotBits;
+
+        struct Entry {
+            TimerId id;
+            uint64_t expiry;  // In ticks
+            uint64_t period;  // In ticks, 0 for one-shot
+            Action action;
+            bool cancelled = false;
+        };
+
+        struct Level {
+            std::array<std::vector<std::shared_ptr<Entry>>, kSlots> slots;
+            std::array<uint64_t, kSlots / 64> occupied{};
+            size_t count = 0;
+        };
+
+        uint64_t toTick(Clock::time_point when) const;
+        void insert(std::shared_ptr<Entry> entry);
+        void cascade(size_t level, size_t slot);
+        void expire(size_t slot, std::vector<Action>& due);
+        void setOccupied(Level& level, size_t slot, bool occupied);
+
+        mutable std::mutex mutex;
+        std::chrono::milliseconds tick;
+        Clock::time_point start;
+        uint64_t currentTick = 0;
+        TimerId nextId = 1;
+        std::array<Level, kLevels> levels;
+        std::unordered_map<TimerId, std::shared_ptr<Entry>> live;
+    };
+
+} // namespace adapter
@@ -37,6 +37,59 @@ namespace adapter {
         return currentProfile;
     }
 
+    void FlowContext::setTimeout(std::chrono::milliseconds timeout) {
+        if (timeout.count() > 0) {
+            deadlineTime = std::chrono::steady_clock::now() + timeout;
+        } else {
+            deadlineTime.reset();
+        }
+    }
+
+    bool FlowContext::isTimedOut() const {
+        if (!deadlineTime) return false;
+        return std::chrono::steady_clock::now() > *deadlineTime;
+    }
+
+    void FlowContext::requestCancellation() {
+        cancellationRequested = true;
+    }
+
+    bool FlowContext::isCancellationRequested() const {
+        return cancellationRequested || (boundCancellation && *boundCancellation);
+    }
+
+    void FlowContext::bindCancellation(const std::atomic<bool>* flag) {
+        boundCancellation = flag;
+    }
+
+    bool FlowContext::isPreemptionRequested() const {
+        return boundPreemption && *boundPreemption;
+    }
+
+    void FlowContext::bindPreemption(const std::atomic<bool>* flag) {
+        boundPreemption = flag;
+    }
+
+    bool FlowContext::shouldContinue() const {
+        return !isCancellationRequested() && !isTimedOut() && !isPreemptionRequested();
+    }
+
+    void FlowContext::yield() {
+        yieldRequested = true;
+    }
+
+    bool FlowContext::hasYielded() const {
+        return yieldRequested;
+    }
+
+    bool FlowContext::shouldYield() const {
+        return isPreemptionRequested() || (yieldCheck && yieldCheck());
+    }
+
+    void FlowContext::setYieldCheck(std::function<bool()> check) {
+        yieldCheck = std::move(check);
+    }
+
     std::chrono::nanoseconds FlowContext::ProfileData::duration() const {
         return endTime - startTime;
     }
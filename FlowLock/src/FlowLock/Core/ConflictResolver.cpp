@@ -2,6 +2,7 @@
 #include "FlowLock/Scheduler/FlowTask.h"
 #include "FlowLock/Utils/FlowTracer.h"
 #include <algorithm>
+#include <stdexcept>
 #include <sstream>
 #include <iostream> 
 
@@ -11,13 +12,90 @@ namespace adapter {
         : defaultPolicy(Policy::SHARED) {
     }
 
-    void ConflictResolver::setPolicy(const std::string& tag, Policy policy) {
-        policies[tag] = policy;
+    std::vector<std::shared_ptr<FlowTask>> ConflictResolver::setPolicy(const std::string& tag, Policy policy,
+        uint32_t limit) {
+        return setPolicy(TagRegistry::instance().intern(tag), policy, limit);
+    }
+
+    std::vector<std::shared_ptr<FlowTask>> ConflictResolver::setPolicy(TagId tag, Policy policy, uint32_t limit) {
+        if (policy == Policy::LIMITED && limit == 0) {
+            throw std::runtime_error("ConflictResolver: LIMITED policy needs a limit of at least 1");
+        }
+
+        PolicySetting setting{ policy, policy == Policy::LIMITED ? limit : 1 };
+        auto& state = stateOf(tag);
+        if (state.setting.load(std::memory_order_acquire) == setting) {
+            return {};
+        }
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.setting.store(setting, std::memory_order_release);
+        }
+
+        // A looser policy or a raised limit may admit tasks already waiting on the tag.
+        std::vector<std::shared_ptr<FlowTask>> ready;
+        std::vector<const FlowTask*> boosted;
+        wakeWaiters(tag, ready, boosted);
+        notifyBoosted(boosted);
+        return ready;
+    }
+
+    std::vector<std::shared_ptr<FlowTask>> ConflictResolver::setRateLimit(const std::string& tag, uint32_t starts,
+        std::chrono::milliseconds window, uint32_t burst) {
+        return setRateLimit(TagRegistry::instance().intern(tag), starts, window, burst);
+    }
+
+    std::vector<std::shared_ptr<FlowTask>> ConflictResolver::setRateLimit(TagId tag, uint32_t starts,
+        std::chrono::milliseconds window, uint32_t burst) {
+        int64_t interval = 0;
+        if (starts > 0) {
+            if (window.count() <= 0) {
+                throw std::runtime_error("ConflictResolver: rate limit window must be positive");
+            }
+            interval = std::max<int64_t>(1, std::chrono::nanoseconds(window).count() / starts);
+        }
+
+        auto& state = stateOf(tag);
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.tokenInterval = interval;
+            state.burstAllowance = interval * (static_cast<int64_t>(burst > 0 ? burst : starts) - 1);
+        }
+        return refill(tag);
+    }
+
+    void ConflictResolver::setRefillCallback(RefillCallback callback) {
+        std::atomic_store(&refillCallback, std::shared_ptr<const RefillCallback>(
+            std::make_shared<RefillCallback>(std::move(callback))));
+    }
+
+    std::vector<std::shared_ptr<FlowTask>> ConflictResolver::refill(TagId tag) {
+        auto& state = stateOf(tag);
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.refillScheduled = false;
+        }
+
+        std::vector<std::shared_ptr<FlowTask>> ready;
+        std::vector<const FlowTask*> boosted;
+        wakeWaiters(tag, ready, boosted);
+        notifyBoosted(boosted);
+        return ready;
     }
 
     ConflictResolver::Policy ConflictResolver::getPolicy(const std::string& tag) const {
-        auto it = policies.find(tag);
-        return (it != policies.end()) ? it->second : defaultPolicy;
+        auto id = TagRegistry::instance().find(tag);
+        return id ? getPolicy(*id) : defaultPolicy;
+    }
+
+    ConflictResolver::Policy ConflictResolver::getPolicy(TagId tag) const {
+        const TagState* state = findState(tag);
+        return state ? state->setting.load().policy : defaultPolicy;
+    }
+
+    uint32_t ConflictResolver::getLimit(TagId tag) const {
+        const TagState* state = findState(tag);
+        return state ? state->setting.load().limit : 1;
     }
 
     bool ConflictResolver::canExecute(const std::shared_ptr<FlowTask>& task,
@@ -26,21 +104,20 @@ namespace adapter {
             return true;
         }
 
-        const auto& tags = task->getTags();
+        const auto& tags = task->getTagIds();
 
         if (tags.empty()) {
             return true;
         }
 
-        for (const auto& tag : tags) {
+        for (TagId tag : tags) {
             auto policy = getPolicy(tag);
 
             if (policy == Policy::EXCLUSIVE) {
                 for (const auto& runningTask : runningTasks) {
-                    const auto& runningTaskTags = runningTask->getTags();
-                    if (std::find(runningTaskTags.begin(), runningTaskTags.end(), tag) != runningTaskTags.end()) {
+                    if (runningTask->hasTag(tag)) {
                         std::stringstream reason;
-                        reason << "Exclusive tag conflict on '" << tag << "'";
+                        reason << "Exclusive tag conflict on '" << TagRegistry::instance().name(tag) << "'";
                         try {
                             FlowTracer::instance().recordConflictDetected(task, reason.str());
                         }
@@ -51,11 +128,9 @@ namespace adapter {
             }
             else if (policy == Policy::PRIORITY) {
                 for (const auto& runningTask : runningTasks) {
-                    const auto& runningTaskTags = runningTask->getTags();
-                    if (std::find(runningTaskTags.begin(), runningTaskTags.end(), tag) != runningTaskTags.end() &&
-                        task->getPriority() <= runningTask->getPriority()) {
+                    if (runningTask->hasTag(tag) && task->getPriority() <= runningTask->getPriority()) {
                         std::stringstream reason;
-                        reason << "Priority conflict on tag '" << tag << "': "
+                        reason << "Priority conflict on tag '" << TagRegistry::instance().name(tag) << "': "
                             << "Current task (priority " << task->getPriority()
                             << ") <= Running task (priority " << runningTask->getPriority() << ")";
                         try {
@@ -66,23 +141,430 @@ namespace adapter {
                     }
                 }
             }
+            else if (policy == Policy::LIMITED) {
+                auto users = std::count_if(runningTasks.begin(), runningTasks.end(),
+                    [tag](const std::shared_ptr<FlowTask>& runningTask) { return runningTask->hasTag(tag); });
+                if (static_cast<uint32_t>(users) >= getLimit(tag)) {
+                    std::stringstream reason;
+                    reason << "Limit of " << getLimit(tag) << " reached on tag '"
+                        << TagRegistry::instance().name(tag) << "'";
+                    try {
+                        FlowTracer::instance().recordConflictDetected(task, reason.str());
+                    }
+                    catch (...) {}
+                    return false;
+                }
+            }
             // For SHARED policy, we don't need to check anything
         }
 
         return true;
     }
 
+    bool ConflictResolver::canExecute(const std::shared_ptr<FlowTask>& task) const {
+        if (!task) {
+            return true;
+        }
+
+        for (TagId tag : task->getTagIds()) {
+            const TagState* state = findState(tag);
+            if (state && findConflict(*task, tag, *state, true)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t ConflictResolver::getHolderCount(TagId tag) const {
+        const TagState* state = findState(tag);
+        return state ? state->holderCount.load() : 0;
+    }
+
+    uint32_t ConflictResolver::getMaxHolderPriority(TagId tag) const {
+        const TagState* state = findState(tag);
+        return state ? state->maxHolderPriority.load() : 0;
+    }
+
+    bool ConflictResolver::WaiterOrder::operator()(const Waiter& a, const Waiter& b) const {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        return a.task->getWaitingSince() < b.task->getWaitingSince();
+    }
+
+    class ConflictResolver::TagLocks {
+    public:
+        TagLocks(ConflictResolver& resolver, const FlowTask& task)
+            : resolver(resolver), tags(task.getSortedLockIds()) {
+            for (TagId tag : tags) {
+                resolver.stateOf(tag);  // Allocation may throw; nothing is locked yet
+            }
+            for (TagId tag : tags) {
+                resolver.stateOf(tag).mutex.lock();
+            }
+        }
+
+        ~TagLocks() {
+            for (auto it = tags.rbegin(); it != tags.rend(); ++it) {
+                resolver.stateOf(*it).mutex.unlock();
+            }
+        }
+
+        TagLocks(const TagLocks&) = delete;
+        TagLocks& operator=(const TagLocks&) = delete;
+
+    private:
+        ConflictResolver& resolver;
+        const std::vector<TagId>& tags;
+    };
+
+    bool ConflictResolver::tryAcquire(const std::shared_ptr<FlowTask>& task) {
+        if (!task || task->getTagIds().empty()) {
+            return true;
+        }
+        if (task->isHoldingTags()) {
+            return true;  // Tags were handed over by release()
+        }
+
+        std::vector<const FlowTask*> boosted;
+        TagId blockedOn;
+        {
+            TagLocks locks(*this, *task);
+            auto blockingTag = findConflict(*task, true);
+            if (!blockingTag) {
+                hold(task);
+                return true;
+            }
+
+            blockedOn = *blockingTag;
+            waitingCount++;
+            task->markWaiting();
+            park(blockedOn, { waiterScore(*task), task }, boosted);
+        }
+        notifyBoosted(boosted);
+
+        if (FlowTracer::instance().isEnabled()) {
+            std::stringstream reason;
+            reason << "Task parked on busy tag '" << TagRegistry::instance().name(blockedOn) << "'";
+            try {
+                FlowTracer::instance().recordConflictDetected(task, reason.str());
+            }
+            catch (...) {}
+        }
+        return false;
+    }
+
+    std::vector<std::shared_ptr<FlowTask>> ConflictResolver::release(const std::shared_ptr<FlowTask>& task) {
+        std::vector<std::shared_ptr<FlowTask>> ready;
+        if (!task || !task->setHoldingTags(false)) {
+            return ready;
+        }
+
+        {
+            TagLocks locks(*this, *task);
+            for (TagId tag : task->getTagIds()) {
+                auto& state = stateOf(tag);
+                auto holder = std::find_if(state.holders.begin(), state.holders.end(),
+                    [&](const Holder& h) { return h.task == task.get(); });
+                bool writer = holder->writes;
+                if (writer) {
+                    state.writerCount--;
+                }
+                state.holders.erase(holder);
+                for (TagId ancestor : task->getAncestors(tag)) {
+                    auto& ancestorState = stateOf(ancestor);
+                    ancestorState.subtreeHolders--;
+                    if (writer) {
+                        ancestorState.subtreeWriters--;
+                    }
+                }
+
+                uint32_t maxPriority = 0;
+                for (const Holder& h : state.holders) {
+                    maxPriority = std::max(maxPriority, h.task->getPriority());
+                }
+                state.maxHolderPriority = maxPriority;
+                state.holderCount = static_cast<uint32_t>(state.holders.size());
+            }
+            task->clearInheritedPriority();
+        }
+
+        // Baton passing: waiters that can now claim all their tags get them here, and go
+        // back to the caller already holding them. Ancestors are included, as their
+        // waiters may have been blocked by this task's subtree.
+        std::vector<const FlowTask*> boosted;
+        for (TagId tag : task->getSortedLockIds()) {
+            wakeWaiters(tag, ready, boosted);
+        }
+        notifyBoosted(boosted);
+        return ready;
+    }
+
+    size_t ConflictResolver::getWaitingCount() const {
+        return waitingCount;
+    }
+
+    void ConflictResolver::setPriorityBoostCallback(PriorityBoostCallback callback) {
+        std::atomic_store(&boostCallback, std::shared_ptr<const PriorityBoostCallback>(
+            std::make_shared<PriorityBoostCallback>(std::move(callback))));
+    }
+
+    void ConflictResolver::setAgingInterval(std::chrono::milliseconds interval) {
+        agingIntervalMs = interval.count();
+    }
+
+    const ConflictResolver::TagState* ConflictResolver::findState(TagId tag) const {
+        const ChunkBlock* block = tagBlocks[tag / (kChunkSize * kChunksPerBlock)].load(std::memory_order_acquire);
+        if (!block) {
+            return nullptr;
+        }
+        const TagState* states = (*block)[tag / kChunkSize % kChunksPerBlock].load(std::memory_order_acquire);
+        return states ? &states[tag % kChunkSize] : nullptr;
+    }
+
+    ConflictResolver::TagState& ConflictResolver::stateOf(TagId tag) {
+        auto& blockSlot = tagBlocks[tag / (kChunkSize * kChunksPerBlock)];
+        ChunkBlock* block = blockSlot.load(std::memory_order_acquire);
+        if (!block) {
+            std::lock_guard<std::mutex> lock(chunkMutex);
+            block = blockSlot.load(std::memory_order_relaxed);
+            if (!block) {
+                ownedBlocks.push_back(std::make_unique<ChunkBlock>());
+                block = ownedBlocks.back().get();
+                blockSlot.store(block, std::memory_order_release);
+            }
+        }
+
+        auto& chunkSlot = (*block)[tag / kChunkSize % kChunksPerBlock];
+        TagState* states = chunkSlot.load(std::memory_order_acquire);
+        if (!states) {
+            std::lock_guard<std::mutex> lock(chunkMutex);
+            states = chunkSlot.load(std::memory_order_relaxed);
+            if (!states) {
+                ownedChunks.emplace_back(new TagState[kChunkSize]);
+                states = ownedChunks.back().get();
+                for (size_t i = 0; i < kChunkSize; ++i) {
+                    states[i].setting.store({ defaultPolicy, 1 }, std::memory_order_relaxed);
+                }
+                chunkSlot.store(states, std::memory_order_release);
+            }
+        }
+        return states[tag % kChunkSize];
+    }
+
+    bool ConflictResolver::writes(const FlowTask& task, TagId tag, const TagState& state) const {
+        switch (task.getTagAccess(tag)) {
+        case TagAccess::READ: return false;
+        case TagAccess::WRITE: return true;
+        default: {
+            Policy policy = state.setting.load().policy;
+            return policy == Policy::EXCLUSIVE || policy == Policy::PRIORITY;
+        }
+        }
+    }
+
+    bool ConflictResolver::conflicts(bool writer, const TagState& state, bool fresh) const {
+        if (state.tokenInterval > 0 && nowNanos() < state.nextTokenAt) {
+            return true;
+        }
+        if (writer) {
+            return state.holderCount > 0 || state.subtreeHolders > 0;
+        }
+        if (state.writerCount > 0 || state.subtreeWriters > 0 || (fresh && state.writersWaiting > 0)) {
+            return true;
+        }
+        PolicySetting setting = state.setting;
+        return setting.policy == Policy::LIMITED && state.holderCount >= setting.limit;
+    }
+
+    bool ConflictResolver::conflictsWithAncestor(bool writer, const TagState& ancestor, bool fresh) const {
+        if (fresh && ancestor.writersWaiting > 0) {
+            return true;
+        }
+        return writer ? ancestor.holderCount > 0 : ancestor.writerCount > 0;
+    }
+
+    std::optional<TagId> ConflictResolver::findConflict(const FlowTask& task, TagId tag, const TagState& state,
+        bool fresh) const {
+        bool writer = writes(task, tag, state);
+        if (conflicts(writer, state, fresh)) {
+            return tag;
+        }
+        for (TagId ancestor : task.getAncestors(tag)) {
+            const TagState* ancestorState = findState(ancestor);
+            if (ancestorState && conflictsWithAncestor(writer, *ancestorState, fresh)) {
+                return ancestor;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<TagId> ConflictResolver::findConflict(const FlowTask& task, bool fresh) {
+        for (TagId tag : task.getTagIds()) {
+            const TagState* state = findState(tag);
+            if (!state) {
+                continue;
+            }
+            // A fresh claim must not take the token a rate-limited tag's waiters are due.
+            if (fresh && state->tokenInterval > 0 && !state->waiters.empty()) {
+                return tag;
+            }
+            if (auto blockingTag = findConflict(task, tag, *state, fresh)) {
+                return blockingTag;
+            }
+        }
+        return std::nullopt;
+    }
+
+    int64_t ConflictResolver::nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void ConflictResolver::takeToken(TagState& state) {
+        // Each claim moves the bucket one interval along, never starting further back
+        // than the burst allows.
+        int64_t due = std::max(state.nextTokenAt + state.burstAllowance, nowNanos()) + state.tokenInterval;
+        state.nextTokenAt = due - state.burstAllowance;
+    }
+
+    void ConflictResolver::scheduleRefill(TagId tag, TagState& state) {
+        int64_t nextToken = state.nextTokenAt;
+        if (state.tokenInterval == 0 || state.refillScheduled || nowNanos() >= nextToken) {
+            return;
+        }
+
+        auto callback = std::atomic_load(&refillCallback);
+        if (callback && *callback) {
+            state.refillScheduled = true;
+            (*callback)(tag, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(nextToken)));
+        }
+    }
+
+    void ConflictResolver::hold(const std::shared_ptr<FlowTask>& task) {
+        for (TagId tag : task->getTagIds()) {
+            auto& state = stateOf(tag);
+            bool writer = writes(*task, tag, state);
+            state.holders.push_back({ task.get(), writer });
+            if (writer) {
+                state.writerCount++;
+            }
+            if (state.tokenInterval > 0) {
+                takeToken(state);
+            }
+            for (TagId ancestor : task->getAncestors(tag)) {
+                auto& ancestorState = stateOf(ancestor);
+                ancestorState.subtreeHolders++;
+                if (writer) {
+                    ancestorState.subtreeWriters++;
+                }
+            }
+            state.holderCount = static_cast<uint32_t>(state.holders.size());
+            if (task->getPriority() > state.maxHolderPriority) {
+                state.maxHolderPriority = task->getPriority();
+            }
+        }
+        task->setHoldingTags(true);
+    }
+
+    double ConflictResolver::waiterScore(const FlowTask& task) const {
+        double score = task.getPriority();
+        int64_t interval = agingIntervalMs;
+        if (interval > 0) {
+            std::chrono::duration<double, std::milli> parkedAt = task.getWaitingSince() - epoch;
+            score -= parkedAt.count() / interval;
+        }
+        return score;
+    }
+
+    void ConflictResolver::wakeWaiters(TagId tag, std::vector<std::shared_ptr<FlowTask>>& ready,
+        std::vector<const FlowTask*>& boosted) {
+        auto& state = stateOf(tag);
+
+        while (true) {
+            std::shared_ptr<FlowTask> candidate;
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (state.waiters.empty()) {
+                    return;
+                }
+                candidate = state.waiters.begin()->task;
+            }
+
+            // Re-checked under the locks of all the candidate's tags, which include this one.
+            TagLocks locks(*this, *candidate);
+            if (state.waiters.empty() || state.waiters.begin()->task != candidate) {
+                continue;  // Another release got to it first
+            }
+
+            auto blockingTag = findConflict(*candidate, false);
+            if (blockingTag && *blockingTag == tag) {
+                scheduleRefill(tag, state);
+                return;  // Still blocked here; the waiters behind it keep their turn
+            }
+
+            Waiter head = *state.waiters.begin();
+            state.waiters.erase(state.waiters.begin());
+            if (head.writes) {
+                state.writersWaiting--;
+            }
+            if (blockingTag) {
+                park(*blockingTag, std::move(head), boosted);
+                continue;
+            }
+
+            waitingCount--;
+            hold(candidate);
+            ready.push_back(std::move(candidate));
+        }
+    }
+
+    void ConflictResolver::park(TagId tag, Waiter waiter, std::vector<const FlowTask*>& boosted) {
+        auto& state = stateOf(tag);
+        uint32_t priority = waiter.task->getPriority();
+        if (state.setting.load().policy == Policy::PRIORITY && state.maxHolderPriority < priority) {
+            // Checked before the boost below lifts the holders to this priority.
+            for (const Holder& holder : state.holders) {
+                if (holder.task->getEffectivePriority() < priority) {
+                    holder.task->requestPreemption();
+                }
+            }
+        }
+        for (const Holder& holder : state.holders) {
+            if (holder.task->inheritPriority(priority)) {
+                boosted.push_back(holder.task);
+            }
+        }
+        // A task parked on an ancestor of its tags is not a writer of the ancestor itself.
+        waiter.writes = waiter.task->hasTag(tag) && writes(*waiter.task, tag, state);
+        if (waiter.writes) {
+            state.writersWaiting++;
+        }
+        state.waiters.insert(std::move(waiter));
+        scheduleRefill(tag, state);
+    }
+
+    void ConflictResolver::notifyBoosted(const std::vector<const FlowTask*>& boosted) {
+        // Outside the tag locks; the callback only uses the pointers as keys.
+        if (boosted.empty()) return;
+
+        auto callback = std::atomic_load(&boostCallback);
+        if (callback && *callback) {
+            for (const FlowTask* holder : boosted) {
+                (*callback)(holder);
+            }
+        }
+    }
+
     bool ConflictResolver::checkExclusiveConflict(const std::shared_ptr<FlowTask>& task,
         const std::vector<std::shared_ptr<FlowTask>>& runningTasks) const {
-        const auto& taskTags = task->getTags();
+        const auto& taskTags = task->getTagIds();
 
         for (const auto& runningTask : runningTasks) {
-            const auto& runningTaskTags = runningTask->getTags();
-
-            for (const auto& tag : taskTags) {
-                if (std::find(runningTaskTags.begin(), runningTaskTags.end(), tag) != runningTaskTags.end()) {
+            for (TagId tag : taskTags) {
+                if (runningTask->hasTag(tag)) {
                     std::stringstream reason;
-                    reason << "Exclusive tag conflict on '" << tag << "'";
+                    reason << "Exclusive tag conflict on '" << TagRegistry::instance().name(tag) << "'";
                     FlowTracer::instance().recordConflictDetected(task, reason.str());
 
                     return false;
@@ -95,15 +577,13 @@ namespace adapter {
 
     bool ConflictResolver::checkPriorityConflict(const std::shared_ptr<FlowTask>& task,
         const std::vector<std::shared_ptr<FlowTask>>& runningTasks) const {
-        const auto& taskTags = task->getTags();
+        const auto& taskTags = task->getTagIds();
 
         for (const auto& runningTask : runningTasks) {
-            const auto& runningTaskTags = runningTask->getTags();
-
             bool hasTagOverlap = false;
-            std::string overlappingTag;
-            for (const auto& tag : taskTags) {
-                if (std::find(runningTaskTags.begin(), runningTaskTags.end(), tag) != runningTaskTags.end()) {
+            TagId overlappingTag = 0;
+            for (TagId tag : taskTags) {
+                if (runningTask->hasTag(tag)) {
                     hasTagOverlap = true;
                     overlappingTag = tag;
                     break;
@@ -112,7 +592,7 @@ namespace adapter {
 
             if (hasTagOverlap && task->getPriority() <= runningTask->getPriority()) {
                 std::stringstream reason;
-                reason << "Priority conflict on tag '" << overlappingTag << "': "
+                reason << "Priority conflict on tag '" << TagRegistry::instance().name(overlappingTag) << "': "
                     << "Current task (priority " << task->getPriority()
                     << ") <= Running task (priority " << runningTask->getPriority() << ")";
                 FlowTracer::instance().recordConflictDetected(task, reason.str());
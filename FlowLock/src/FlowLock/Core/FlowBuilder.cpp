@@ -1,6 +1,7 @@
 #include "FlowLock/Core/FlowBuilder.h"
 #include "FlowLock/FlowLockImpl.h"
 #include "FlowLock/Context/FlowContext.h"
+#include "FlowLock/Scheduler/FlowTask.h"
 
 namespace adapter {
 
@@ -21,11 +22,33 @@ FlowBuilder& FlowBuilder::withTags(const std::vector<std::string>& t) {
     return *this;
 }
 
+FlowBuilder& FlowBuilder::reads(const std::string& tag) {
+    tags.push_back(tag);
+    tagAccess.emplace_back(TagRegistry::instance().intern(tag), TagAccess::READ);
+    return *this;
+}
+
+FlowBuilder& FlowBuilder::writes(const std::string& tag) {
+    tags.push_back(tag);
+    tagAccess.emplace_back(TagRegistry::instance().intern(tag), TagAccess::WRITE);
+    return *this;
+}
+
 FlowBuilder& FlowBuilder::withTimeout(std::chrono::milliseconds t) {
     timeout = t;
     return *this;
 }
 
+FlowBuilder& FlowBuilder::withDelay(std::chrono::milliseconds d) {
+    delay = d;
+    return *this;
+}
+
+FlowBuilder& FlowBuilder::withTenant(const std::string& t) {
+    tenant = t;
+    return *this;
+}
+
 FlowBuilder& FlowBuilder::exclusive() {
     hasCustomPolicy = true;
     customPolicy = ConflictResolver::Policy::EXCLUSIVE;
@@ -44,6 +67,33 @@ FlowBuilder& FlowBuilder::prioritized() {
     return *this;
 }
 
+FlowBuilder& FlowBuilder::limited(uint32_t limit) {
+    hasCustomPolicy = true;
+    customPolicy = ConflictResolver::Policy::LIMITED;
+    customLimit = limit;
+    return *this;
+}
+
+void FlowBuilder::applyPolicy() {
+    if (hasCustomPolicy && !tags.empty()) {
+        for (const auto& tag : tags) {
+            FlowLockImpl::instance().setPolicy(tag, customPolicy, customLimit);
+        }
+    }
+}
+
+void FlowBuilder::configure(FlowTask& task) const {
+    if (timeout.count() > 0) {
+        task.setDeadline(std::chrono::steady_clock::now() + delay + timeout);
+    }
+    if (!tenant.empty()) {
+        task.setTenant(tenant);
+    }
+    for (const auto& [tag, access] : tagAccess) {
+        task.addTag(tag, access);
+    }
+}
+
 ScopedTask::ScopedTask(const std::string& name, uint32_t p)
     : taskName(name), priority(p) {
     tags.push_back("section:" + name);
@@ -0,0 +1,185 @@
+#include "FlowLock/Core/FlowGraph.h"
+#include "FlowLock/FlowLockImpl.h"
+#include "FlowLock/Scheduler/FlowTask.h"
+#include "FlowLock/Context/FlowContext.h"
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+namespace adapter {
+
+    // State of one submission. Every node task keeps it alive until the last one finishes.
+    struct FlowGraph::Run : std::enable_shared_from_this<FlowGraph::Run> {
+        explicit Run(const std::vector<Node>& graphNodes)
+            : nodes(graphNodes),
+            pending(new std::atomic<size_t>[graphNodes.size()]),
+            skipped(new std::atomic<bool>[graphNodes.size()]),
+            remaining(graphNodes.size()) {
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                pending[i] = nodes[i].predecessorCount;
+                skipped[i] = false;
+            }
+        }
+
+        std::shared_ptr<FlowTask> makeTask(NodeId id) {
+            const Node& node = nodes[id];
+            auto task = std::make_shared<FlowTask>(
+                [run = shared_from_this(), id](FlowContext& context) {
+                    std::exception_ptr error;
+                    try {
+                        run->nodes[id].function(context);
+                        if (context.hasYielded()) {
+                            return;
+                        }
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                    run->finish(id, error);
+                },
+                node.priority
+            );
+            task->setAbandonHandler([run = shared_from_this(), id](std::exception_ptr reason) {
+                run->finish(id, reason);
+            });
+
+            for (const auto& tag : node.tags) {
+                task->addTag(tag);
+            }
+            return task;
+        }
+
+        void finish(NodeId id, std::exception_ptr error) {
+            if (error) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) {
+                    firstError = error;
+                }
+            }
+
+            // A failed node finishes its whole downstream cone as skipped right here.
+            std::vector<std::shared_ptr<FlowTask>> ready;
+            std::vector<std::pair<NodeId, bool>> finished{ { id, error != nullptr } };
+
+            while (!finished.empty()) {
+                auto [node, failed] = finished.back();
+                finished.pop_back();
+
+                for (NodeId next : nodes[node].successors) {
+                    if (failed) {
+                        skipped[next] = true;
+                    }
+                    if (--pending[next] == 0) {
+                        if (skipped[next]) {
+                            finished.push_back({ next, true });
+                        } else {
+                            ready.push_back(makeTask(next));
+                        }
+                    }
+                }
+
+                if (--remaining == 0) {
+                    complete();
+                }
+            }
+
+            if (!ready.empty()) {
+                FlowLockImpl::instance().submitTasks(std::move(ready));
+            }
+        }
+
+        void complete() {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (firstError) {
+                done.set_exception(firstError);
+            } else {
+                done.set_value();
+            }
+        }
+
+        std::vector<Node> nodes;
+        std::unique_ptr<std::atomic<size_t>[]> pending;   // Unfinished predecessors per node
+        std::unique_ptr<std::atomic<bool>[]> skipped;
+        std::atomic<size_t> remaining;
+        std::mutex errorMutex;
+        std::exception_ptr firstError;
+        std::promise<void> done;
+    };
+
+    FlowGraph::NodeId FlowGraph::addNode(NodeFunction function, uint32_t priority, const std::vector<std::string>& tags) {
+        nodes.push_back({ std::move(function), priority, tags, {}, 0 });
+        return nodes.size() - 1;
+    }
+
+    void FlowGraph::precede(NodeId before, NodeId after) {
+        checkNode(before);
+        checkNode(after);
+
+        nodes[before].successors.push_back(after);
+        nodes[after].predecessorCount++;
+    }
+
+    void FlowGraph::dependsOn(NodeId node, const std::vector<NodeId>& predecessors) {
+        for (NodeId predecessor : predecessors) {
+            precede(predecessor, node);
+        }
+    }
+
+    size_t FlowGraph::size() const {
+        return nodes.size();
+    }
+
+    std::future<void> FlowGraph::submit() const {
+        if (!isAcyclic()) {
+            throw std::runtime_error("FlowGraph: dependency cycle");
+        }
+
+        auto run = std::make_shared<Run>(nodes);
+        auto future = run->done.get_future();
+        if (nodes.empty()) {
+            run->done.set_value();
+            return future;
+        }
+
+        std::vector<std::shared_ptr<FlowTask>> roots;
+        for (NodeId id = 0; id < nodes.size(); ++id) {
+            if (nodes[id].predecessorCount == 0) {
+                roots.push_back(run->makeTask(id));
+            }
+        }
+
+        FlowLockImpl::instance().submitTasks(std::move(roots));
+        return future;
+    }
+
+    void FlowGraph::checkNode(NodeId node) const {
+        if (node >= nodes.size()) {
+            throw std::runtime_error("FlowGraph: unknown node " + std::to_string(node));
+        }
+    }
+
+    bool FlowGraph::isAcyclic() const {
+        std::vector<size_t> pending(nodes.size());
+        std::vector<NodeId> ready;
+        for (NodeId id = 0; id < nodes.size(); ++id) {
+            pending[id] = nodes[id].predecessorCount;
+            if (pending[id] == 0) {
+                ready.push_back(id);
+            }
+        }
+
+        size_t visited = 0;
+        while (!ready.empty()) {
+            NodeId id = ready.back();
+            ready.pop_back();
+            visited++;
+
+            for (NodeId next : nodes[id].successors) {
+                if (--pending[next] == 0) {
+                    ready.push_back(next);
+                }
+            }
+        }
+        return visited == nodes.size();
+    }
+
+} // namespace adapter
@@ -11,13 +11,12 @@ namespace adapter {
 
     FlowProfiler::FlowProfiler() = default;
 
-    void FlowProfiler::recordTaskExecution(const std::string& tag, uint32_t priority, std::chrono::nanoseconds duration) {
+    void FlowProfiler::recordTaskExecution(TagId tag, uint32_t priority, std::chrono::nanoseconds duration) {
         if (!enabled) return;
 
         std::lock_guard<std::mutex> lock(mutex);
 
-        auto& metric = metrics[tag];
-        metric.tag = tag;
+        auto& metric = metricFor(tag);
         metric.priority = priority;
         metric.executionCount++;
         metric.totalExecutionTime += duration;
@@ -35,61 +34,88 @@ namespace adapter {
         }
     }
 
-    void FlowProfiler::recordTaskQueued(const std::string& tag, uint32_t priority) {
+    void FlowProfiler::recordTaskQueued(TagId tag, uint32_t priority) {
         if (!enabled) return;
 
         std::lock_guard<std::mutex> lock(mutex);
 
-        auto& metric = metrics[tag];
-        metric.tag = tag;
+        auto& metric = metricFor(tag);
         metric.priority = priority;
         metric.queuedCount++;
     }
 
-    void FlowProfiler::recordTaskCancelled(const std::string& tag, uint32_t priority) {
+    void FlowProfiler::recordTaskCancelled(TagId tag, uint32_t priority) {
         if (!enabled) return;
 
         std::lock_guard<std::mutex> lock(mutex);
 
-        auto& metric = metrics[tag];
-        metric.tag = tag;
+        auto& metric = metricFor(tag);
         metric.priority = priority;
         metric.cancelledCount++;
     }
 
-    void FlowProfiler::recordTaskTimedOut(const std::string& tag, uint32_t priority) {
+    void FlowProfiler::recordTaskTimedOut(TagId tag, uint32_t priority) {
         if (!enabled) return;
 
         std::lock_guard<std::mutex> lock(mutex);
 
-        auto& metric = metrics[tag];
-        metric.tag = tag;
+        auto& metric = metricFor(tag);
         metric.priority = priority;
         metric.timedOutCount++;
     }
 
-    void FlowProfiler::recordTaskFailed(const std::string& tag, uint32_t priority) {
+    void FlowProfiler::recordTaskFailed(TagId tag, uint32_t priority) {
         if (!enabled) return;
 
         std::lock_guard<std::mutex> lock(mutex);
 
-        auto& metric = metrics[tag];
-        metric.tag = tag;
+        auto& metric = metricFor(tag);
         metric.priority = priority;
         metric.failedCount++;
     }
 
-    void FlowProfiler::recordTaskReEnqueued(const std::string& tag, uint32_t priority) {
+    void FlowProfiler::recordTaskReEnqueued(TagId tag, uint32_t priority) {
         if (!enabled) return;
 
         std::lock_guard<std::mutex> lock(mutex);
 
-        auto& metric = metrics[tag];
-        metric.tag = tag;
+        auto& metric = metricFor(tag);
         metric.priority = priority;
         metric.reEnqueuedCount++;
     }
 
+    void FlowProfiler::recordTaskExecution(const std::string& tag, uint32_t priority, std::chrono::nanoseconds duration) {
+        recordTaskExecution(TagRegistry::instance().intern(tag), priority, duration);
+    }
+
+    void FlowProfiler::recordTaskQueued(const std::string& tag, uint32_t priority) {
+        recordTaskQueued(TagRegistry::instance().intern(tag), priority);
+    }
+
+    void FlowProfiler::recordTaskCancelled(const std::string& tag, uint32_t priority) {
+        recordTaskCancelled(TagRegistry::instance().intern(tag), priority);
+    }
+
+    void FlowProfiler::recordTaskTimedOut(const std::string& tag, uint32_t priority) {
+        recordTaskTimedOut(TagRegistry::instance().intern(tag), priority);
+    }
+
+    void FlowProfiler::recordTaskFailed(const std::string& tag, uint32_t priority) {
+        recordTaskFailed(TagRegistry::instance().intern(tag), priority);
+    }
+
+    void FlowProfiler::recordTaskReEnqueued(const std::string& tag, uint32_t priority) {
+        recordTaskReEnqueued(TagRegistry::instance().intern(tag), priority);
+    }
+
+    TaskMetrics& FlowProfiler::metricFor(TagId tag) {
+        auto [it, inserted] = metrics.try_emplace(tag);
+        if (inserted) {
+            it->second.tag = TagRegistry::instance().name(tag);  // Only on a tag's first record
+        }
+        return it->second;
+    }
+
     std::vector<TaskMetrics> FlowProfiler::getAllMetrics() const {
         std::lock_guard<std::mutex> lock(mutex);
 
@@ -104,9 +130,14 @@ namespace adapter {
     }
 
     std::optional<TaskMetrics> FlowProfiler::getMetricsForTag(const std::string& tag) const {
+        auto id = TagRegistry::instance().find(tag);
+        if (!id) {
+            return std::nullopt;
+        }
+
         std::lock_guard<std::mutex> lock(mutex);
 
-        auto it = metrics.find(tag);
+        auto it = metrics.find(*id);
         if (it != metrics.end()) {
             return it->second;
         }
@@ -122,7 +153,8 @@ namespace adapter {
         ss << "\"metrics\":[";
 
         bool first = true;
-        for (const auto& [tag, metric] : metrics) {
+        for (const auto& [id, metric] : metrics) {
+            const std::string& tag = metric.tag;
             if (!first) {
                 ss << ",";
             }
@@ -154,7 +186,8 @@ namespace adapter {
 
         std::stringstream ss;
 
-        for (const auto& [tag, metric] : metrics) {
+        for (const auto& [id, metric] : metrics) {
+            const std::string& tag = metric.tag;
             ss << "flow_task_execution_count{tag=\"" << tag << "\",priority=\"" << metric.priority << "\"} " << metric.executionCount << "\n";
             ss << "flow_task_total_execution_time_ms{tag=\"" << tag << "\",priority=\"" << metric.priority << "\"} " << std::chrono::duration_cast<std::chrono::milliseconds>(metric.totalExecutionTime).count() << "\n";
             ss << "flow_task_min_execution_time_ms{tag=\"" << tag << "\",priority=\"" << metric.priority << "\"} " << std::chrono::duration_cast<std::chrono::milliseconds>(metric.minExecutionTime).count() << "\n";
@@ -0,0 +1,88 @@
+#include "FlowLock/Core/TagRegistry.h"
+#include <mutex>
+#include <stdexcept>
+
+namespace adapter {
+
+    TagRegistry& TagRegistry::instance() {
+        static TagRegistry registry;
+        return registry;
+    }
+
+    TagId TagRegistry::intern(const std::string& tag) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = ids.find(tag);
+            if (it != ids.end()) {
+                return it->second;
+            }
+        }
+
+        // Parents first, so an ancestor always has a lower id than its descendants.
+        std::optional<TagId> parentId;
+        size_t separator = tag.rfind(kSeparator);
+        if (separator != std::string::npos && separator > 0) {
+            parentId = intern(tag.substr(0, separator));
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto [it, inserted] = ids.emplace(tag, static_cast<TagId>(tagNames.size()));
+        if (inserted) {
+            tagNames.push_back(tag);
+            tagParents.push_back(parentId);
+        }
+        return it->second;
+    }
+
+    std::optional<TagId> TagRegistry::find(const std::string& tag) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(tag);
+        if (it == ids.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    const std::string& TagRegistry::name(TagId id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (id >= tagNames.size()) {
+            throw std::runtime_error("TagRegistry: unknown tag id " + std::to_string(id));
+        }
+        return tagNames[id];
+    }
+
+    std::vector<std::string> TagRegistry::names(const std::vector<TagId>& tagIds) const {
+        std::vector<std::string> result;
+        result.reserve(tagIds.size());
+        for (TagId id : tagIds) {
+            result.push_back(name(id));
+        }
+        return result;
+    }
+
+    std::optional<TagId> TagRegistry::parent(TagId id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (id >= tagParents.size()) {
+            throw std::runtime_error("TagRegistry: unknown tag id " + std::to_string(id));
+        }
+        return tagParents[id];
+    }
+
+    std::vector<TagId> TagRegistry::ancestors(TagId id) const {
+        std::vector<TagId> result;
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (id >= tagParents.size()) {
+            throw std::runtime_error("TagRegistry: unknown tag id " + std::to_string(id));
+        }
+        for (auto current = tagParents[id]; current; current = tagParents[*current]) {
+            result.push_back(*current);
+        }
+        return result;
+    }
+
+    size_t TagRegistry::size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return tagNames.size();
+    }
+
+} // namespace adapter
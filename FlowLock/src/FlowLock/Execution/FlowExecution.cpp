@@ -6,7 +6,6 @@
 #include <algorithm>
 #include <thread>
 #include <exception>
-#include <iostream>
 
 namespace adapter {
 
@@ -15,8 +14,6 @@ namespace adapter {
     }
 
     void FlowExecution::executeTask(std::shared_ptr<FlowTask> task) {
-        std::cerr << "[DEBUG] FlowExecution::executeTask CALLED\n";
-        
         if (!task) return;
 
         bool taskRegistered = false;
@@ -24,14 +21,17 @@ namespace adapter {
             {
                 std::lock_guard<std::mutex> lock(runningTasksMutex);
                 runningTasks.push_back(task);
+                runningCount = runningTasks.size();
                 taskRegistered = true;
-                std::cerr << "Task execution started - running tasks: " << runningTasks.size() << std::endl;
             }
 
             static std::atomic<uint32_t> nextThreadId{ 0 };
             static std::atomic<uint64_t> nextLogicalTick{ 0 };
 
             FlowContext context(nextThreadId++, nextLogicalTick++, true);
+            context.setYieldCheck([this, current = task.get()]() {
+                return scheduler.hasTaskAbove(current->getEffectivePriority());
+            });
 
             std::exception_ptr capturedExcep = nullptr;
             bool taskExecuted = false;
@@ -47,14 +47,12 @@ namespace adapter {
                 context.endProfiling();
 
                 executionCounter++;
-                std::cerr << "Task executed successfully - counter: " << executionCounter << std::endl;
 
                 try {
                     FlowTracer::instance().recordTaskCompleted(task, context);
                 } catch (...) {}
             }
             catch (const std::exception& e) {
-                std::cerr << "Task execution failed with exception: " << e.what() << std::endl;
                 try {
                     FlowTracer::instance().recordTaskFailed(task, context, e.what());
                 }
@@ -63,7 +61,6 @@ namespace adapter {
                 capturedExcep = std::current_exception();
             }
             catch (...) {
-                std::cerr << "Task execution failed with unknown exception" << std::endl;
                 try {
                     FlowTracer::instance().recordTaskFailed(task, context, "Unknown error");
                 }
@@ -72,18 +69,24 @@ namespace adapter {
                 capturedExcep = std::current_exception();
             }
 
+            // Requeued before it leaves the running list, so it is never invisible to await().
+            bool yielded = !capturedExcep && context.hasYielded() && yieldedCallback;
+            if (yielded) {
+                yieldedCallback(task);
+            }
+
             {
                 std::lock_guard<std::mutex> lock(runningTasksMutex);
                 auto it = std::find(runningTasks.begin(), runningTasks.end(), task);
                 if (it != runningTasks.end()) {
                     runningTasks.erase(it);
-                    std::cerr << "Task removed from running tasks - remaining: " << runningTasks.size() << std::endl;
-                } else {
-                    std::cerr << "WARNING: Task not found in running tasks list!" << std::endl;
+                    runningCount = runningTasks.size();
                 }
             }
 
-            notifyTaskCompleted(task);
+            if (!yielded) {
+                notifyTaskCompleted(task);
+            }
 
             if (capturedExcep && taskExecuted) {
                 std::rethrow_exception(capturedExcep);
@@ -95,8 +98,7 @@ namespace adapter {
                 auto it = std::find(runningTasks.begin(), runningTasks.end(), task);
                 if (it != runningTasks.end()) {
                     runningTasks.erase(it);
-                    std::cerr << "Emergency task cleanup from running tasks - remaining: " 
-                            << runningTasks.size() << std::endl;
+                    runningCount = runningTasks.size();
                 }
             }
             throw; 
@@ -107,11 +109,19 @@ namespace adapter {
         completionCallback = callback;
     }
 
+    void FlowExecution::setTaskYieldedCallback(TaskCompletionCallback callback) {
+        yieldedCallback = callback;
+    }
+
     std::vector<std::shared_ptr<FlowTask>> FlowExecution::getRunningTasks() const {
         std::lock_guard<std::mutex> lock(runningTasksMutex);
         return runningTasks;
     }
 
+    size_t FlowExecution::getRunningCount() const {
+        return runningCount;
+    }
+
     void FlowExecution::notifyTaskCompleted(const std::shared_ptr<FlowTask>& task) {
         if (completionCallback) {
             completionCallback(task);
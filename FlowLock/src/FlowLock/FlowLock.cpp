@@ -17,14 +17,36 @@ void FlowLock::setThreadPoolSize(size_t size) {
     FlowLockImpl::instance().setThreadPoolSize(size);
 }
 
-void FlowLock::setPolicy(const std::string& tag, ConflictResolver::Policy policy) {
-    FlowLockImpl::instance().setPolicy(tag, policy);
+void FlowLock::setPolicy(const std::string& tag, ConflictResolver::Policy policy, uint32_t limit) {
+    FlowLockImpl::instance().setPolicy(tag, policy, limit);
+}
+
+void FlowLock::setRateLimit(const std::string& tag, uint32_t starts, std::chrono::milliseconds window,
+    uint32_t burst) {
+    FlowLockImpl::instance().setRateLimit(tag, starts, window, burst);
 }
 
 void FlowLock::setDefaultPolicy(ConflictResolver::Policy policy) {
     FlowLockImpl::instance().setDefaultPolicy(policy);
 }
 
+void FlowLock::setSchedulerStrategy(FlowScheduler::Strategy strategy) {
+    FlowLockImpl::instance().setSchedulerStrategy(strategy);
+}
+
+void FlowLock::setFairShareWeight(const std::string& key, uint32_t weight) {
+    FlowLockImpl::instance().setFairShareWeight(key, weight);
+}
+
+void FlowLock::setQueueCapacity(size_t capacity, FlowScheduler::OverflowPolicy policy,
+    std::chrono::milliseconds blockTimeout) {
+    FlowLockImpl::instance().setQueueCapacity(capacity, policy, blockTimeout);
+}
+
+bool FlowLock::cancelTimer(TimingWheel::TimerId id) {
+    return FlowLockImpl::instance().cancelTimer(id);
+}
+
 void FlowLock::shutdown() {
     FlowLockImpl::instance().shutdown();
 }
@@ -8,11 +8,17 @@
 #include <thread>
 #include <chrono>
 #include <sstream>
-#include <iostream>
-#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
 
 namespace adapter {
 
+thread_local FlowLockImpl::Worker* FlowLockImpl::currentWorker = nullptr;
+
+namespace {
+thread_local bool onTimerThread = false;
+}
+
 FlowLockImpl& FlowLockImpl::instance() {
     static FlowLockImpl instance;
     return instance;
@@ -30,8 +36,34 @@ FlowLockImpl::FlowLockImpl()
             onTaskCompleted(task);
         }
     );
-    
-    std::unordered_map<void*, size_t>* reEnqueueCounts = new std::unordered_map<void*, size_t>();
+
+    execution->setTaskYieldedCallback(
+        [this](const std::shared_ptr<FlowTask>& task) {
+            onTaskYielded(task);
+        }
+    );
+
+    conflictResolver->setPriorityBoostCallback(
+        [this](const FlowTask* holder) {
+            scheduler->promote(holder);
+        }
+    );
+
+    conflictResolver->setRefillCallback(
+        [this](TagId tag, TimingWheel::Clock::time_point when) {
+            scheduleTimer(when, [this, tag]() {
+                handOff(conflictResolver->refill(tag));
+            });
+        }
+    );
+
+    scheduler->setTaskDroppedCallback(
+        [this](const std::shared_ptr<FlowTask>& task) {
+            onTaskDropped(task);
+        }
+    );
+
+    applyAging();
 }
 
 FlowLockImpl::~FlowLockImpl() {
@@ -39,29 +71,25 @@ FlowLockImpl::~FlowLockImpl() {
 }
 
 bool FlowLockImpl::await(std::chrono::milliseconds timeout) {
-    auto endTime = std::chrono::steady_clock::now() + timeout;
-    
-    while (std::chrono::steady_clock::now() < endTime) {
-        if (!scheduler->hasTasks() && execution->getRunningTasks().empty()) {
-            return true;
-        }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
-    
-    return !scheduler->hasTasks() && execution->getRunningTasks().empty();
+    std::unique_lock<std::mutex> lock(processMutex);
+    return scheduleCondVar.wait_for(lock, timeout, [this] { return isIdle(); });
+}
+
+bool FlowLockImpl::isIdle() const {
+    return !scheduler->hasTasks() && localQueuedCount() == 0 && conflictResolver->getWaitingCount() == 0
+        && execution->getRunningCount() == 0;
 }
 
 void FlowLockImpl::shutdown() {
     stopping = true;
-    threadPool->waitForTasks();
+    stopTimers();
+    stopWorkers();
     await();
 }
 
 void FlowLockImpl::run() {
     const int maxIterations = 100;
     int iteration = 0;
-    int tasksProcessed = 0;
 
     while (scheduler->hasTasks() && iteration < maxIterations) {
         iteration++;
@@ -69,78 +97,283 @@ void FlowLockImpl::run() {
         auto task = scheduler->dequeueTask();
         if (!task) continue;
 
-        std::vector<std::shared_ptr<FlowTask>> currentRunningTasks = execution->getRunningTasks();
+        dispatch(task);
+    }
+}
+
+void FlowLockImpl::dispatch(const std::shared_ptr<FlowTask>& task) {
+    if (task->isCancelled() && !task->hasStarted()) {
+        onTaskDropped(task);  // Its future already failed in cancel()
+        return;
+    }
+    // Also covers tasks that reached dispatch from a local deque, a steal or a wait
+    // list, which never pass the scheduler's expiry check.
+    if (!task->hasStarted() && task->isTimedOut()) {
+        task->abandon(std::make_exception_ptr(std::runtime_error("FlowLock: task deadline expired before it started")));
+        onTaskDropped(task);
+        return;
+    }
+
+    if (!conflictResolver->tryAcquire(task)) {
+        // Parked on the blocking tag's wait list until a holder releases it.
+        reEnqueuedTaskCount++;
+        task->incrementReenqueueCount();
+        return;
+    }
+
+    if (!task->hasStarted()) {
+        scheduler->releaseAdmission();  // A resumed task gave its slot back the first time
+    }
+    try {
+        execution->executeTask(task);
+    } catch (...) {
+        failedTaskCount++;
+    }
+}
+
+void FlowLockImpl::handOff(std::vector<std::shared_ptr<FlowTask>> readyTasks) {
+    if (readyTasks.empty()) return;
+
+    // These already hold their tags. On a worker they run next on the same thread,
+    // and any extra ones can be stolen by idle workers.
+    if (currentWorker && !workersStopping) {
+        size_t extraTasks = readyTasks.size() - 1;
+        localQueued += readyTasks.size();
+        currentWorker->deque.pushBack(readyTasks);
+        if (extraTasks > 0) {
+            scheduler->notifyWorkAvailable(extraTasks);
+        }
+    } else {
+        scheduler->enqueueTasks(std::move(readyTasks));
+    }
+}
+
+void FlowLockImpl::submitTask(std::shared_ptr<FlowTask> task) {
+    if (!task || !admit(task)) return;
+
+    pushAdmitted(std::move(task));
+}
+
+void FlowLockImpl::submitDetached(std::shared_ptr<FlowTask> task) {
+    if (!task || !reserveSlot(task)) return;
+
+    pushAdmitted(std::move(task));
+}
+
+bool FlowLockImpl::admit(const std::shared_ptr<FlowTask>& task) {
+    adoptByCurrentTask(task);
+    return reserveSlot(task);
+}
+
+bool FlowLockImpl::reserveSlot(const std::shared_ptr<FlowTask>& task) {
+    // Workers and the timer thread must keep draining, so they never wait for room.
+    bool mayBlock = !currentWorker && !onTimerThread;
+    if (scheduler->admit(task, mayBlock)) {
+        return true;
+    }
+
+    failedTaskCount++;
+    task->abandon(std::make_exception_ptr(std::runtime_error("FlowLock: scheduler queue is full")));
+    return false;
+}
+
+void FlowLockImpl::adoptByCurrentTask(const std::shared_ptr<FlowTask>& task) {
+    if (FlowTask* parent = FlowTask::current()) {
+        parent->adoptChild(task);
+    }
+}
+
+void FlowLockImpl::pushAdmitted(std::shared_ptr<FlowTask> task) {
+    if (currentWorker && !workersStopping) {
+        localQueued++;
+        currentWorker->deque.pushBack(std::move(task));
+        scheduler->notifyWorkAvailable();  // Lets an idle worker steal it
+    } else {
+        scheduler->enqueueTask(std::move(task));
+    }
+
+    scheduleCondVar.notify_one();
+}
+
+void FlowLockImpl::submitTasks(std::vector<std::shared_ptr<FlowTask>> tasks) {
+    tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
+        [this](const std::shared_ptr<FlowTask>& task) { return !task || !admit(task); }), tasks.end());
+    if (tasks.empty()) return;
+
+    if (currentWorker && !workersStopping) {
+        size_t taskCount = tasks.size();
+        localQueued += taskCount;
+        currentWorker->deque.pushBack(tasks);
+        scheduler->notifyWorkAvailable(taskCount);
+    } else {
+        scheduler->enqueueTasks(std::move(tasks));
+    }
+
+    scheduleCondVar.notify_all();
+}
+
+TimingWheel::TimerId FlowLockImpl::submitTaskAt(std::shared_ptr<FlowTask> task, TimingWheel::Clock::time_point when) {
+    return scheduleTimer(when, [this, task = std::move(task)]() {
+        submitTask(task);
+    });
+}
+
+TimingWheel::TimerId FlowLockImpl::submitTasksAt(std::vector<std::shared_ptr<FlowTask>> tasks, TimingWheel::Clock::time_point when) {
+    return scheduleTimer(when, [this, tasks = std::move(tasks)]() {
+        submitTasks(tasks);
+    });
+}
+
+bool FlowLockImpl::cancelTimer(TimingWheel::TimerId id) {
+    return timers.cancel(id);
+}
+
+TimingWheel::TimerId FlowLockImpl::scheduleTimer(TimingWheel::Clock::time_point when, TimingWheel::Action action,
+    std::chrono::milliseconds period) {
+    TimingWheel::TimerId id = timers.schedule(when, std::move(action), period);
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        if (!timerThread.joinable() && !timerStopping) {
+            timerThread = std::thread([this]() { timerLoop(); });
+        }
+    }
+    timerCondVar.notify_one();
+    return id;
+}
 
-        if (conflictResolver->canExecute(task, currentRunningTasks)) {
+void FlowLockImpl::timerLoop() {
+    onTimerThread = true;
+    std::unique_lock<std::mutex> lock(timerMutex);
+
+    while (!timerStopping) {
+        // Sleeps until the wheel's next slot is due; scheduleTimer wakes it earlier.
+        auto wakeup = timers.nextWakeup();
+        if (wakeup) {
+            timerCondVar.wait_until(lock, *wakeup);
+        } else {
+            timerCondVar.wait(lock);
+        }
+        if (timerStopping) break;
+
+        lock.unlock();
+        for (auto& action : timers.advance(TimingWheel::Clock::now())) {
             try {
-                execution->executeTask(task);
-                tasksProcessed++;
+                action();
             } catch (...) {
-                failedTaskCount++;
             }
         }
-        else {
-            scheduler->enqueueTask(task);
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+        lock.lock();
+    }
+}
+
+void FlowLockImpl::stopTimers() {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        timerStopping = true;
+    }
+    timerCondVar.notify_all();
+    if (timerThread.joinable()) {
+        timerThread.join();
     }
 }
 
 void FlowLockImpl::setThreadPoolSize(size_t threads) {
-    threadPool = std::make_unique<ThreadPool>(threads);
-    
+    stopWorkers();
+
     for (size_t i = 0; i < threads; ++i) {
-        threadPool->enqueue([this]() {
-            while (!stopping) {
-                this->run(); 
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->index = i;
+    }
+
+    threadPool = std::make_unique<ThreadPool>(threads);
+    for (auto& worker : workers) {
+        threadPool->enqueue([this, w = worker.get()]() {
+            workerLoop(*w);
         });
     }
-    
-    std::cerr << "[FlowLock] Thread pool initialized with " << threads << " threads.\n";
 }
 
-void FlowLockImpl::processNextTask() {
-    std::shared_ptr<FlowTask> task;
-    {
-        std::lock_guard<std::mutex> lock(processMutex);
-        task = scheduler->dequeueTask();
+void FlowLockImpl::stopWorkers() {
+    if (!threadPool) return;
+
+    workersStopping = true;
+    scheduler->wakeAll();
+    threadPool.reset();  // Joins the worker loops
+
+    // Whatever is left in local deques goes back to the global queue.
+    for (auto& worker : workers) {
+        while (auto task = worker->deque.stealFront()) {
+            scheduler->enqueueTask(task);
+            localQueued--;
+        }
     }
+    workers.clear();
+    workersStopping = false;
+}
 
-    if (!task) return;
+void FlowLockImpl::workerLoop(Worker& worker) {
+    currentWorker = &worker;
 
-    std::vector<std::shared_ptr<FlowTask>> currentRunningTasks = execution->getRunningTasks();
+    while (!stopping && !workersStopping) {
+        auto task = nextTaskFor(worker);
+        if (!task) {
+            scheduler->waitForWork([this]() {
+                return stopping || workersStopping || scheduler->hasTasks() || localQueuedCount() != 0;
+            });
+            continue;
+        }
 
-    static std::unordered_map<void*, size_t> taskReEnqueueCount;
-    
-    bool canRun = conflictResolver->canExecute(task, currentRunningTasks);
-    if (!canRun) {
-        void* taskPtr = task.get();
-        auto& count = taskReEnqueueCount[taskPtr];
-        count++;
-        reEnqueuedTaskCount++;
-        
-        if (count > antiStarvationLimit) {
-            canRun = true;
+        dispatch(task);
+    }
+
+    currentWorker = nullptr;
+}
+
+std::shared_ptr<FlowTask> FlowLockImpl::nextTaskFor(Worker& worker) {
+    if (auto local = worker.deque.popBack()) {
+        localQueued--;
+        // Local work goes first unless the global queue holds something more urgent, by
+        // the queue's own order. A queued task is never taken out just to be put back,
+        // which would cost it its place and its aging credit.
+        if (scheduler->hasTaskAbove(local->getEffectivePriority())) {
+            if (auto queued = scheduler->tryDequeueTaskAbove(*local)) {
+                localQueued++;
+                worker.deque.pushBack(std::move(local));
+                return queued;
+            }
         }
+        return local;
     }
-    
-    if (canRun) {
-        try {
-            execution->executeTask(task);
-            
-            void* taskPtr = task.get();
-            taskReEnqueueCount.erase(taskPtr);
-        } catch (...) {
-            failedTaskCount++;
+
+    if (auto queued = scheduler->tryDequeueTask()) {
+        return queued;
+    }
+
+    for (size_t offset = 1; offset < workers.size(); ++offset) {
+        auto& victim = *workers[(worker.index + offset) % workers.size()];
+        if (auto stolen = victim.deque.stealFront()) {
+            localQueued--;
+            return stolen;
         }
     }
-    else {
+
+    return nullptr;
+}
+
+size_t FlowLockImpl::localQueuedCount() const {
+    return localQueued.load();
+}
+
+void FlowLockImpl::processNextTask() {
+    std::shared_ptr<FlowTask> task;
+    {
         std::lock_guard<std::mutex> lock(processMutex);
-        scheduler->enqueueTask(task);
-        task->incrementReenqueueCount();
+        task = scheduler->dequeueTask();
     }
+
+    if (!task) return;
+
+    dispatch(task);
 }
 
 void FlowLockImpl::onTaskCompleted(const std::shared_ptr<FlowTask>& task) {
@@ -156,15 +389,51 @@ void FlowLockImpl::onTaskCompleted(const std::shared_ptr<FlowTask>& task) {
     }
 
     completedTaskCount++;
+    handOff(conflictResolver->release(task));
 
-    try {
-        processNextTask();
-    } catch (...) {
+    // Workers pick up their next task themselves; only callers of run() chain here.
+    if (!currentWorker) {
+        try {
+            processNextTask();
+        } catch (...) {
+        }
     }
 
-    bool allCompleted = !scheduler->hasTasks() && execution->getRunningTasks().empty();
+    notifyIfIdle();
+}
 
-    if (allCompleted) {
+void FlowLockImpl::onTaskDropped(const std::shared_ptr<FlowTask>& task) {
+    failedTaskCount++;
+    if (!task->hasStarted()) {
+        scheduler->releaseAdmission();  // Started tasks released theirs in dispatch
+    }
+    handOff(conflictResolver->release(task));  // In case it was handed tags it never used
+    notifyIfIdle();
+}
+
+void FlowLockImpl::onTaskYielded(const std::shared_ptr<FlowTask>& task) {
+    if (task->isCancelled()) {
+        task->abandon(std::make_exception_ptr(std::runtime_error("FlowLock: task cancelled")));
+        onTaskDropped(task);
+        return;
+    }
+
+    if (task->isPreemptionRequested()) {
+        // Checkpointed for a more urgent waiter: its tags go to that waiter now, and the
+        // task claims them again through the wait list once dispatched.
+        task->clearPreemption();
+        handOff(conflictResolver->release(task));
+    }
+
+    // Back through the global queue so anything more urgent runs first; enqueueing
+    // restarts its aging, so the time it just spent running does not outrank that work.
+    // Unless it was preempted, the task still holds its tags, so dispatch lets it
+    // straight through.
+    scheduler->enqueueTask(task);
+}
+
+void FlowLockImpl::notifyIfIdle() {
+    if (isIdle()) {
         std::lock_guard<std::mutex> lock(processMutex);
         allTasksCompleted = true;
         scheduleCondVar.notify_all();
@@ -175,18 +444,36 @@ void FlowLockImpl::setTaskCompletionCallback(TaskCompletionCallback callback) {
     userCompletionCallback = callback;
 }
 
-void FlowLockImpl::setPolicy(const std::string& tag, ConflictResolver::Policy policy) {
-    conflictResolver->setPolicy(tag, policy);
+void FlowLockImpl::setPolicy(const std::string& tag, ConflictResolver::Policy policy, uint32_t limit) {
+    handOff(conflictResolver->setPolicy(tag, policy, limit));
+}
+
+void FlowLockImpl::setRateLimit(const std::string& tag, uint32_t starts, std::chrono::milliseconds window,
+    uint32_t burst) {
+    handOff(conflictResolver->setRateLimit(tag, starts, window, burst));
 }
 
 void FlowLockImpl::setDefaultPolicy(ConflictResolver::Policy policy) {
     setPolicy("default", policy);
 }
 
+void FlowLockImpl::setSchedulerStrategy(FlowScheduler::Strategy strategy) {
+    scheduler->setStrategy(strategy);
+}
+
+void FlowLockImpl::setFairShareWeight(const std::string& key, uint32_t weight) {
+    scheduler->setFairShareWeight(key, weight);
+}
+
+void FlowLockImpl::setQueueCapacity(size_t capacity, FlowScheduler::OverflowPolicy policy,
+    std::chrono::milliseconds blockTimeout) {
+    scheduler->setCapacity(capacity, policy, blockTimeout);
+}
+
 FlowLockImpl::Stats FlowLockImpl::stats() const {
     return {
-        scheduler->getQueueSize(),
-        execution->getRunningTasks().size(),
+        scheduler->getQueueSize() + localQueuedCount() + conflictResolver->getWaitingCount(),
+        execution->getRunningCount(),
         completedTaskCount.load(),
         failedTaskCount.load(),
         reEnqueuedTaskCount.load()
@@ -222,6 +509,13 @@ std::string FlowLockImpl::debugDump() const {
 
 void FlowLockImpl::setAntiStarvationLimit(size_t limit) {
     antiStarvationLimit = limit;
+    applyAging();
+}
+
+void FlowLockImpl::applyAging() {
+    auto interval = kAgingStep * static_cast<int64_t>(antiStarvationLimit);
+    scheduler->setAgingInterval(interval);
+    conflictResolver->setAgingInterval(interval);
 }
 
 size_t FlowLockImpl::getAntiStarvationLimit() const {
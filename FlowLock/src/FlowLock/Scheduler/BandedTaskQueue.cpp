@@ -0,0 +1,146 @@
+#include "FlowLock/Scheduler/BandedTaskQueue.h"
+#include "FlowLock/Scheduler/FlowTask.h"
+
+namespace adapter {
+
+    namespace {
+        int highestBit(uint64_t mask) {
+            int index = 63;
+            while ((mask & (uint64_t{ 1 } << index)) == 0) {
+                --index;
+            }
+            return index;
+        }
+    }
+
+    BandedTaskQueue::BandedTaskQueue(size_t bandCapacity)
+        : bandCapacity(bandCapacity) {
+        for (auto& band : bands) {
+            band.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    BandedTaskQueue::~BandedTaskQueue() {
+        for (auto& band : bands) {
+            delete band.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t BandedTaskQueue::bandFor(uint32_t priority) {
+        if (priority < kExactBands) {
+            return priority;
+        }
+
+        // 48..63 -> 48, 64..127 -> 49, ... , 2^20 and above -> 63
+        size_t log2 = 0;
+        for (uint32_t value = priority; value > 1; value >>= 1) {
+            ++log2;
+        }
+        size_t band = kExactBands + (log2 - 5);
+        return band < kBandCount ? band : kBandCount - 1;
+    }
+
+    RingTaskQueue& BandedTaskQueue::bandAt(size_t index) {
+        RingTaskQueue* band = bands[index].load(std::memory_order_acquire);
+        if (band) {
+            return *band;
+        }
+
+        auto* created = new RingTaskQueue(bandCapacity);
+        if (bands[index].compare_exchange_strong(band, created, std::memory_order_acq_rel)) {
+            return *created;
+        }
+
+        delete created;
+        return *band;
+    }
+
+    void BandedTaskQueue::push(std::shared_ptr<FlowTask> task) {
+        if (!task) return;
+
+        size_t index = bandFor(task->getEffectivePriority());
+
+        totalCount.fetch_add(1);
+        bandAt(index).push(std::move(task));
+        occupancy.fetch_or(uint64_t{ 1 } << index);
+    }
+
+    std::shared_ptr<FlowTask> BandedTaskQueue::tryPop() {
+        return popHighest(~uint64_t{ 0 });
+    }
+
+    std::shared_ptr<FlowTask> BandedTaskQueue::tryPopAbove(const FlowTask& rival) {
+        // Every band above the rival's holds only higher priorities.
+        size_t rivalBand = bandFor(rival.getEffectivePriority());
+        uint64_t above = rivalBand + 1 < kBandCount ? ~((uint64_t{ 1 } << (rivalBand + 1)) - 1) : 0;
+        return popHighest(above);
+    }
+
+    std::shared_ptr<FlowTask> BandedTaskQueue::popHighest(uint64_t allowed) {
+        uint64_t mask = occupancy.load() & allowed;
+
+        while (mask != 0) {
+            int index = highestBit(mask);
+            uint64_t bit = uint64_t{ 1 } << index;
+            RingTaskQueue* band = bands[index].load(std::memory_order_acquire);
+
+            if (band) {
+                if (auto task = band->tryPop()) {
+                    totalCount.fetch_sub(1);
+                    return task;
+                }
+
+                // Clear the bit, then re-check: a producer racing with us is either counted
+                // already (restore the bit) or will set it again after its push.
+                occupancy.fetch_and(~bit);
+                if (!band->empty()) {
+                    occupancy.fetch_or(bit);
+                }
+            }
+
+            mask &= ~bit;
+        }
+
+        return nullptr;
+    }
+
+    std::shared_ptr<FlowTask> BandedTaskQueue::popLowestBelow(uint32_t priority) {
+        // Only bands strictly below the newcomer's band can be shed.
+        uint64_t mask = occupancy.load() & ((uint64_t{ 1 } << bandFor(priority)) - 1);
+
+        while (mask != 0) {
+            uint64_t bit = mask & (~mask + 1);  // Lowest occupied band
+            int index = highestBit(bit);
+            RingTaskQueue* band = bands[index].load(std::memory_order_acquire);
+
+            if (band) {
+                if (auto task = band->tryPop()) {
+                    if (!task->hasStarted()) {
+                        totalCount.fetch_sub(1);
+                        return task;
+                    }
+                    // A started task holds no admission; it goes to the back of its band
+                    // and the next band up is tried.
+                    band->push(std::move(task));
+                }
+            }
+
+            mask &= ~bit;
+        }
+
+        return nullptr;
+    }
+
+    size_t BandedTaskQueue::size() const {
+        return totalCount.load();
+    }
+
+    bool BandedTaskQueue::hasPriorityAbove(uint32_t priority) const {
+        uint64_t mask = occupancy.load(std::memory_order_relaxed);
+        if (mask == 0) {
+            return false;
+        }
+        return static_cast<size_t>(highestBit(mask)) > bandFor(priority);
+    }
+
+} // namespace adapter
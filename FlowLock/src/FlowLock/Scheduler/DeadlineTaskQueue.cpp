@@ -0,0 +1,78 @@
+#include "FlowLock/Scheduler/DeadlineTaskQueue.h"
+#include "FlowLock/Scheduler/FlowTask.h"
+
+namespace adapter {
+
+    bool DeadlineTaskQueue::DeadlineComparator::operator()(const std::shared_ptr<FlowTask>& a, const std::shared_ptr<FlowTask>& b) const {
+        auto deadlineA = a->getDeadline();
+        auto deadlineB = b->getDeadline();
+        if (deadlineA != deadlineB) {
+            if (!deadlineA) return true;
+            if (!deadlineB) return false;
+            return *deadlineA > *deadlineB;  // Earlier deadline = runs first
+        }
+
+        if (a->getPriority() != b->getPriority()) {
+            return a->getPriority() < b->getPriority();
+        }
+
+        return a->getTimestamp() > b->getTimestamp();
+    }
+
+    void DeadlineTaskQueue::push(std::shared_ptr<FlowTask> task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(std::move(task));
+        publishTop();
+    }
+
+    void DeadlineTaskQueue::pushBulk(std::vector<std::shared_ptr<FlowTask>>& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& task : batch) {
+            if (task) {
+                tasks.push(std::move(task));
+            }
+        }
+        publishTop();
+    }
+
+    std::shared_ptr<FlowTask> DeadlineTaskQueue::tryPop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) {
+            return nullptr;
+        }
+
+        auto task = tasks.top();
+        tasks.pop();
+        publishTop();
+        return task;
+    }
+
+    std::shared_ptr<FlowTask> DeadlineTaskQueue::tryPopAbove(const FlowTask& rival) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty() || tasks.top()->getPriority() <= rival.getEffectivePriority()) {
+            return nullptr;
+        }
+
+        auto task = tasks.top();
+        tasks.pop();
+        publishTop();
+        return task;
+    }
+
+    size_t DeadlineTaskQueue::size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tasks.size();
+    }
+
+    bool DeadlineTaskQueue::hasPriorityAbove(uint32_t priority) const {
+        // The head is the most urgent task; its priority is what a worker compares
+        // local work against.
+        return topPriority.load(std::memory_order_relaxed) > static_cast<int64_t>(priority);
+    }
+
+    void DeadlineTaskQueue::publishTop() {
+        topPriority.store(tasks.empty() ? -1 : static_cast<int64_t>(tasks.top()->getPriority()),
+            std::memory_order_relaxed);
+    }
+
+} // namespace adapter
@@ -0,0 +1,78 @@
+#include "FlowLock/Scheduler/FairTaskQueue.h"
+#include "FlowLock/Scheduler/FlowTask.h"
+#include <algorithm>
+
+namespace adapter {
+
+    const std::string& FairTaskQueue::flowKey(const FlowTask& task) {
+        static const std::string defaultKey;
+        if (!task.getTenant().empty()) {
+            return task.getTenant();
+        }
+        return task.getTagIds().empty() ? defaultKey : TagRegistry::instance().name(task.getTagIds().front());
+    }
+
+    void FairTaskQueue::push(std::shared_ptr<FlowTask> task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pushLocked(std::move(task));
+    }
+
+    void FairTaskQueue::pushBulk(std::vector<std::shared_ptr<FlowTask>>& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& task : batch) {
+            if (task) {
+                pushLocked(std::move(task));
+            }
+        }
+    }
+
+    void FairTaskQueue::pushLocked(std::shared_ptr<FlowTask> task) {
+        Flow& flow = flows[flowKey(*task)];
+
+        // A flow that was idle restarts at the current virtual time instead of
+        // cashing in the share it did not use.
+        double start = std::max(virtualTime, flow.lastFinish);
+        flow.lastFinish = start + 1.0 / flow.weight;
+
+        if (flow.tasks.empty()) {
+            backlogged.emplace(start, &flow);
+        }
+        flow.tasks.emplace_back(start, std::move(task));
+        taskCount++;
+    }
+
+    std::shared_ptr<FlowTask> FairTaskQueue::tryPop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (backlogged.empty()) {
+            return nullptr;
+        }
+
+        Flow* flow = backlogged.begin()->second;
+        backlogged.erase(backlogged.begin());
+
+        auto [start, task] = std::move(flow->tasks.front());
+        flow->tasks.pop_front();
+        virtualTime = start;
+        taskCount--;
+
+        if (!flow->tasks.empty()) {
+            backlogged.emplace(flow->tasks.front().first, flow);
+        }
+        return task;
+    }
+
+    size_t FairTaskQueue::size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return taskCount;
+    }
+
+    bool FairTaskQueue::hasPriorityAbove(uint32_t) const {
+        return false;  // Shares, not priorities, decide the order
+    }
+
+    void FairTaskQueue::setWeight(const std::string& key, uint32_t weight) {
+        std::lock_guard<std::mutex> lock(mutex);
+        flows[key].weight = std::max<uint32_t>(weight, 1);
+    }
+
+} // namespace adapter
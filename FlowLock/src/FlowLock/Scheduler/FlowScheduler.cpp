@@ -1,50 +1,159 @@
 #include "FlowLock/Scheduler/FlowScheduler.h"
 #include "FlowLock/Scheduler/FlowTask.h"
+#include "FlowLock/Scheduler/TaskQueue.h"
+#include "FlowLock/Scheduler/PriorityTaskQueue.h"
+#include "FlowLock/Scheduler/RingTaskQueue.h"
+#include "FlowLock/Scheduler/BandedTaskQueue.h"
+#include "FlowLock/Scheduler/DeadlineTaskQueue.h"
+#include "FlowLock/Scheduler/FairTaskQueue.h"
 #include "FlowLock/Utils/FlowTracer.h"
-#include <iostream>
+#include <limits>
+#include <stdexcept>
 
 namespace adapter {
 
-    bool FlowScheduler::TaskComparator::operator()(const std::shared_ptr<FlowTask>& a, const std::shared_ptr<FlowTask>& b) const {
-        if (a->getPriority() != b->getPriority()) {
-            return a->getPriority() < b->getPriority();  // Higher number = higher priority
+    FlowScheduler::FlowScheduler(Strategy strategy)
+        : currentStrategy(strategy) {
+        for (auto& queue : createdQueues) {
+            queue.store(nullptr, std::memory_order_relaxed);
         }
-
-        return a->getTimestamp() > b->getTimestamp();  // Earlier timestamp = higher priority
+        activeQueue = &queueFor(strategy);
     }
 
-    FlowScheduler::FlowScheduler(Strategy strategy)
-        : currentStrategy(strategy) {
+    FlowScheduler::~FlowScheduler() = default;
+
+    TaskQueue& FlowScheduler::queueFor(Strategy strategy) {
+        auto& queue = queues[static_cast<size_t>(strategy)];
+        if (!queue) {
+            switch (strategy) {
+                case Strategy::FIFO: queue = std::make_unique<RingTaskQueue>(); break;
+                case Strategy::PRIORITY_BANDS: queue = std::make_unique<BandedTaskQueue>(); break;
+                case Strategy::DEADLINE: queue = std::make_unique<DeadlineTaskQueue>(); break;
+                case Strategy::FAIR: queue = std::make_unique<FairTaskQueue>(); break;
+                default: queue = std::make_unique<PriorityTaskQueue>(); break;
+            }
+            createdQueues[static_cast<size_t>(strategy)] = queue.get();
+        }
+        return *queue;
     }
 
     void FlowScheduler::enqueueTask(std::shared_ptr<FlowTask> task) {
         if (!task) return;
 
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            taskQueue.push(task);
-            std::cerr << "Task enqueued successfully - queue size: " << taskQueue.size() << std::endl;
+        task->markWaiting();
+        pushToActive(std::move(task));
+        notifyWorkAvailable();
+    }
+
+    void FlowScheduler::enqueueTasks(std::vector<std::shared_ptr<FlowTask>> tasks) {
+        if (tasks.empty()) return;
+
+        size_t taskCount = tasks.size();
+        auto now = std::chrono::steady_clock::now();
+        for (const auto& task : tasks) {
+            if (task) task->markWaiting(now);
         }
+        TaskQueue* queue = activeQueue.load();
+        queue->pushBulk(tasks);
 
-        condVar.notify_one();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (activeQueue.load() != queue) {
+            drainStale(*queue);
+        }
+
+        notifyWorkAvailable(taskCount);
     }
 
-    std::shared_ptr<FlowTask> FlowScheduler::dequeueTask() {
+    void FlowScheduler::pushToActive(std::shared_ptr<FlowTask> task) {
+        TaskQueue* queue = activeQueue.load();
+        queue->push(std::move(task));
+
+        // Pairs with the fence in setStrategy: either the switcher's drain sees our task,
+        // or we see the new active queue here and move the task ourselves.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (activeQueue.load() != queue) {
+            drainStale(*queue);
+        }
+    }
+
+    void FlowScheduler::drainStale(TaskQueue& stale) {
+        while (auto task = stale.tryPop()) {
+            pushToActive(std::move(task));
+        }
+    }
+
+    void FlowScheduler::notifyWorkAvailable(size_t taskCount) {
+        wakeEpoch++;
+
+        // A consumer registers itself under queueMutex before its last check for work,
+        // so taking the mutex here only when someone is parked avoids a lost wakeup.
+        size_t parked = waitingConsumers.load();
+        if (parked == 0) return;
+
+        { std::lock_guard<std::mutex> lock(queueMutex); }
+        if (taskCount >= parked) {
+            condVar.notify_all();
+        } else {
+            for (size_t i = 0; i < taskCount; ++i) {
+                condVar.notify_one();
+            }
+        }
+    }
+
+    void FlowScheduler::wakeAll() {
+        notifyWorkAvailable(std::numeric_limits<size_t>::max());
+    }
+
+    void FlowScheduler::waitForWork(const std::function<bool()>& ready) {
         std::unique_lock<std::mutex> lock(queueMutex);
-        
-        bool taskAvailable = condVar.wait_for(lock, std::chrono::milliseconds(10), 
-            [this] { return !taskQueue.empty() || stopping; });
-        
-        if (stopping) return nullptr;
-        
-        if (!taskAvailable || taskQueue.empty()) {
-            static std::atomic<uint64_t> emptyCount{ 0 };
-            uint64_t currentEmptyCount = ++emptyCount;
-
-            if (currentEmptyCount % 100 == 0) {
-                fprintf(stderr, "Scheduler empty (count: %llu)\n", static_cast<unsigned long long>(currentEmptyCount));
+        waitingConsumers++;
+        uint64_t seenEpoch = wakeEpoch.load();
+
+        if (!ready()) {
+            condVar.wait(lock, [this, seenEpoch] { return wakeEpoch.load() != seenEpoch; });
+        }
+        waitingConsumers--;
+    }
+
+    std::shared_ptr<FlowTask> FlowScheduler::popLive() {
+        while (auto task = activeQueue.load()->tryPop()) {
+            if (!dropIfDead(task)) {
+                return task;
             }
+        }
+        return nullptr;
+    }
+
+    bool FlowScheduler::dropIfDead(const std::shared_ptr<FlowTask>& task) {
+        if (task->hasStarted()) {
+            return false;
+        }
+        if (task->isCancelled()) {
+            dropTask(task, "FlowLock: task cancelled");
+            return true;
+        }
+        if (task->isTimedOut()) {
+            dropTask(task, "FlowLock: task deadline expired before it started");
+            return true;
+        }
+        return false;
+    }
 
+    void FlowScheduler::dropTask(const std::shared_ptr<FlowTask>& task, const char* reason) {
+        task->abandon(std::make_exception_ptr(std::runtime_error(reason)));
+
+        if (droppedCallback) {
+            droppedCallback(task);
+        }
+    }
+
+    std::shared_ptr<FlowTask> FlowScheduler::tryDequeueTask() {
+        return popLive();
+    }
+
+    std::shared_ptr<FlowTask> FlowScheduler::dequeueTask() {
+        auto task = popLive();
+        if (!task) {
             try {
                 FlowTracer::instance().recordSchedulerEmpty();
             }
@@ -54,20 +163,127 @@ namespace adapter {
             return nullptr;
         }
 
-        auto task = taskQueue.top();
-        taskQueue.pop();
-        std::cerr << "Task dequeued - remaining queue size: " << taskQueue.size() << std::endl;
         return task;
     }
 
+    std::shared_ptr<FlowTask> FlowScheduler::tryDequeueTaskAbove(const FlowTask& rival) {
+        while (auto task = activeQueue.load()->tryPopAbove(rival)) {
+            if (!dropIfDead(task)) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
     bool FlowScheduler::hasTasks() const {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        return !taskQueue.empty();
+        return getQueueSize() != 0;
+    }
+
+    bool FlowScheduler::hasTaskAbove(uint32_t priority) const {
+        return activeQueue.load()->hasPriorityAbove(priority);
     }
 
     void FlowScheduler::setStrategy(Strategy strategy) {
         std::lock_guard<std::mutex> lock(queueMutex);
+        if (strategy == currentStrategy) return;
+
+        TaskQueue* previous = activeQueue.load();
+        activeQueue = &queueFor(strategy);
         currentStrategy = strategy;
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        drainStale(*previous);
+    }
+
+    void FlowScheduler::promote(const FlowTask* task) {
+        activeQueue.load()->promote(task);
+    }
+
+    void FlowScheduler::setCapacity(size_t newCapacity, OverflowPolicy policy, std::chrono::milliseconds timeout) {
+        {
+            std::lock_guard<std::mutex> lock(capacityMutex);
+            blockTimeout = timeout;
+            overflowPolicy = policy;
+            capacity = newCapacity;
+        }
+        capacityCondVar.notify_all();
+    }
+
+    size_t FlowScheduler::getCapacity() const {
+        return capacity;
+    }
+
+    bool FlowScheduler::tryAdmit() {
+        size_t current = admittedCount.load();
+        do {
+            size_t limit = capacity.load();
+            if (limit != 0 && current >= limit) {
+                return false;
+            }
+        } while (!admittedCount.compare_exchange_weak(current, current + 1));
+        return true;
+    }
+
+    bool FlowScheduler::admit(const std::shared_ptr<FlowTask>& task, bool mayBlock) {
+        if (tryAdmit()) {
+            return true;
+        }
+
+        switch (overflowPolicy.load()) {
+            case OverflowPolicy::BLOCK: {
+                if (!mayBlock) {
+                    admittedCount++;
+                    return true;
+                }
+
+                std::unique_lock<std::mutex> lock(capacityMutex);
+                blockedSubmitters++;
+                bool admitted = capacityCondVar.wait_for(lock, blockTimeout, [this] { return tryAdmit(); });
+                blockedSubmitters--;
+                return admitted;
+            }
+            case OverflowPolicy::SHED_LOWEST: {
+                auto victim = activeQueue.load()->popLowestBelow(task ? task->getPriority() : 0);
+                if (!victim) {
+                    return false;
+                }
+                // The victim's slot goes to the newcomer; the dropped callback releases
+                // the victim's own admission.
+                admittedCount++;
+                dropTask(victim, "FlowLock: task shed to admit higher-priority work");
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    void FlowScheduler::releaseAdmission() {
+        // Saturates so tasks pushed straight into the queue, bypassing admit(), cannot
+        // wrap the count around.
+        size_t current = admittedCount.load();
+        do {
+            if (current == 0) return;
+        } while (!admittedCount.compare_exchange_weak(current, current - 1));
+
+        if (blockedSubmitters.load() > 0) {
+            { std::lock_guard<std::mutex> lock(capacityMutex); }
+            capacityCondVar.notify_one();
+        }
+    }
+
+    void FlowScheduler::setAgingInterval(std::chrono::milliseconds interval) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        static_cast<PriorityTaskQueue&>(queueFor(Strategy::PRIORITY)).setAgingInterval(interval);
+    }
+
+    void FlowScheduler::setFairShareWeight(const std::string& key, uint32_t weight) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        static_cast<FairTaskQueue&>(queueFor(Strategy::FAIR)).setWeight(key, weight);
+    }
+
+    void FlowScheduler::setTaskDroppedCallback(TaskDroppedCallback callback) {
+        droppedCallback = callback;
     }
 
     FlowScheduler::Strategy FlowScheduler::getStrategy() const {
@@ -75,8 +291,14 @@ namespace adapter {
     }
 
     size_t FlowScheduler::getQueueSize() const {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        return taskQueue.size();
+        // Includes tasks still in flight from a previous strategy's queue.
+        size_t size = 0;
+        for (const auto& queue : createdQueues) {
+            if (TaskQueue* created = queue.load()) {
+                size += created->size();
+            }
+        }
+        return size;
     }
 
-} // namespace adapter
\ No newline at end of file
+} // namespace adapter
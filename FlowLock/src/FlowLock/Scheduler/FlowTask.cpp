@@ -1,54 +1,223 @@
 #include "FlowLock/Scheduler/FlowTask.h"
 #include "FlowLock/Context/FlowContext.h"
 #include <algorithm>
+#include <stdexcept>
 
 namespace adapter {
 
+namespace {
+thread_local FlowTask* currentTask = nullptr;
+
+struct CurrentTaskScope {
+    explicit CurrentTaskScope(FlowTask* task) : previous(currentTask) { currentTask = task; }
+    ~CurrentTaskScope() { currentTask = previous; }
+    FlowTask* previous;
+};
+}
+
 FlowTask::FlowTask(TaskFunction function, uint32_t priority,
     std::chrono::steady_clock::time_point timestamp)
-    : function(function), priority(priority), timestamp(timestamp) {
+    : function(function), priority(priority), timestamp(timestamp), waitingSince(timestamp) {
+}
+
+void FlowTask::addTag(const std::string& tag, TagAccess access) {
+    addTag(TagRegistry::instance().intern(tag), access);
 }
 
-void FlowTask::addTag(const std::string& tag) {
-    if (std::find(tags.begin(), tags.end(), tag) == tags.end()) {
+void FlowTask::addTag(TagId tag, TagAccess access) {
+    auto position = std::lower_bound(sortedTags.begin(), sortedTags.end(), tag);
+    auto index = position - sortedTags.begin();
+    if (position == sortedTags.end() || *position != tag) {
+        auto addLockTag = [this](TagId lockTag) {
+            auto lockPosition = std::lower_bound(lockTags.begin(), lockTags.end(), lockTag);
+            if (lockPosition == lockTags.end() || *lockPosition != lockTag) {
+                lockTags.insert(lockPosition, lockTag);
+            }
+        };
+        auto ancestors = TagRegistry::instance().ancestors(tag);
+        addLockTag(tag);
+        for (TagId ancestor : ancestors) {
+            addLockTag(ancestor);
+        }
+
+        sortedTags.insert(position, tag);
+        sortedAccess.insert(sortedAccess.begin() + index, access);
+        sortedAncestors.insert(sortedAncestors.begin() + index, std::move(ancestors));
         tags.push_back(tag);
+    } else if (access > sortedAccess[index]) {
+        sortedAccess[index] = access;
+    }
+}
+
+TagAccess FlowTask::getTagAccess(TagId tag) const {
+    auto position = std::lower_bound(sortedTags.begin(), sortedTags.end(), tag);
+    if (position == sortedTags.end() || *position != tag) {
+        return TagAccess::DEFAULT;
     }
+    return sortedAccess[position - sortedTags.begin()];
 }
 
 bool FlowTask::hasTag(const std::string& tag) const {
-    return std::find(tags.begin(), tags.end(), tag) != tags.end();
+    auto id = TagRegistry::instance().find(tag);
+    return id && hasTag(*id);
 }
 
-const std::vector<std::string>& FlowTask::getTags() const {
+bool FlowTask::hasTag(TagId tag) const {
+    return std::binary_search(sortedTags.begin(), sortedTags.end(), tag);
+}
+
+const std::vector<TagId>& FlowTask::getTagIds() const {
     return tags;
 }
 
+std::vector<std::string> FlowTask::getTags() const {
+    return TagRegistry::instance().names(tags);
+}
+
+const std::vector<TagId>& FlowTask::getSortedTagIds() const {
+    return sortedTags;
+}
+
+const std::vector<TagId>& FlowTask::getSortedLockIds() const {
+    return lockTags;
+}
+
+const std::vector<TagId>& FlowTask::getAncestors(TagId tag) const {
+    static const std::vector<TagId> none;
+    auto position = std::lower_bound(sortedTags.begin(), sortedTags.end(), tag);
+    if (position == sortedTags.end() || *position != tag) {
+        return none;
+    }
+    return sortedAncestors[position - sortedTags.begin()];
+}
+
+bool FlowTask::setHoldingTags(bool holding) {
+    return holdingTags.exchange(holding);
+}
+
+bool FlowTask::isHoldingTags() const {
+    return holdingTags;
+}
+
+void FlowTask::setTenant(const std::string& t) {
+    tenant = t;
+}
+
+const std::string& FlowTask::getTenant() const {
+    return tenant;
+}
+
 uint32_t FlowTask::getPriority() const {
     return priority;
 }
 
+uint32_t FlowTask::getEffectivePriority() const {
+    return std::max(priority, inheritedPriority.load());
+}
+
+bool FlowTask::inheritPriority(uint32_t p) {
+    uint32_t current = inheritedPriority.load();
+    while (std::max(priority, current) < p) {
+        if (inheritedPriority.compare_exchange_weak(current, p)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FlowTask::clearInheritedPriority() {
+    inheritedPriority = 0;
+}
+
 std::chrono::steady_clock::time_point FlowTask::getTimestamp() const {
     return timestamp;
 }
 
+void FlowTask::markWaiting(std::chrono::steady_clock::time_point since) {
+    waitingSince = since;
+}
+
+std::chrono::steady_clock::time_point FlowTask::getWaitingSince() const {
+    return waitingSince;
+}
+
 void FlowTask::execute(FlowContext& context) {
-    if (cancelled || isTimedOut()) {
+    // Races with cancel(): exactly one of them moves the task out of PENDING.
+    Lifecycle expected = Lifecycle::PENDING;
+    if (!lifecycle.compare_exchange_strong(expected, Lifecycle::STARTED) && expected == Lifecycle::ABANDONED) {
         return;
     }
-    
+
+    context.bindCancellation(&cancelled);
+    context.bindPreemption(&preemptionRequested);
+    CurrentTaskScope scope(this);
     if (function) {
         function(context);
     }
 }
 
+bool FlowTask::hasStarted() const {
+    return lifecycle == Lifecycle::STARTED;
+}
+
 void FlowTask::cancel() {
-    cancelled = true;
+    std::vector<std::weak_ptr<FlowTask>> toCancel;
+    {
+        std::lock_guard<std::mutex> lock(childMutex);
+        if (cancelled.exchange(true)) {
+            return;
+        }
+        toCancel.swap(children);
+    }
+
+    Lifecycle expected = Lifecycle::PENDING;
+    if (lifecycle.compare_exchange_strong(expected, Lifecycle::ABANDONED)) {
+        abandon(std::make_exception_ptr(std::runtime_error("FlowLock: task cancelled")));
+    }
+
+    for (const auto& weakChild : toCancel) {
+        if (auto child = weakChild.lock()) {
+            child->cancel();
+        }
+    }
+}
+
+void FlowTask::adoptChild(const std::shared_ptr<FlowTask>& child) {
+    {
+        std::lock_guard<std::mutex> lock(childMutex);
+        if (!cancelled) {
+            // Long-lived parents spawn many children; forget the finished ones as we go.
+            if (children.size() >= 64 && children.size() == children.capacity()) {
+                children.erase(std::remove_if(children.begin(), children.end(),
+                    [](const std::weak_ptr<FlowTask>& weakChild) { return weakChild.expired(); }), children.end());
+            }
+            children.push_back(child);
+            return;
+        }
+    }
+    child->cancel();
+}
+
+FlowTask* FlowTask::current() {
+    return currentTask;
 }
 
 bool FlowTask::isCancelled() const {
     return cancelled;
 }
 
+void FlowTask::requestPreemption() {
+    preemptionRequested = true;
+}
+
+bool FlowTask::isPreemptionRequested() const {
+    return preemptionRequested;
+}
+
+void FlowTask::clearPreemption() {
+    preemptionRequested = false;
+}
+
 void FlowTask::setTimeout(std::chrono::milliseconds timeout) {
     if (timeout.count() > 0) {
         deadlineTime = std::chrono::steady_clock::now() + timeout;
@@ -57,11 +226,33 @@ void FlowTask::setTimeout(std::chrono::milliseconds timeout) {
     }
 }
 
+void FlowTask::setDeadline(std::chrono::steady_clock::time_point deadline) {
+    deadlineTime = deadline;
+}
+
+std::optional<std::chrono::steady_clock::time_point> FlowTask::getDeadline() const {
+    return deadlineTime;
+}
+
 bool FlowTask::isTimedOut() const {
     if (!deadlineTime) return false;
     return std::chrono::steady_clock::now() > *deadlineTime;
 }
 
+void FlowTask::setAbandonHandler(AbandonHandler handler) {
+    abandonHandler = std::move(handler);
+}
+
+void FlowTask::abandon(std::exception_ptr reason) {
+    if (abandoned.exchange(true)) {
+        return;
+    }
+    if (abandonHandler) {
+        abandonHandler(reason);
+        abandonHandler = nullptr;
+    }
+}
+
 void FlowTask::incrementReenqueueCount() {
     reenqueueCount++;
 }
@@ -0,0 +1,154 @@
+#include "FlowLock/Scheduler/PriorityTaskQueue.h"
+#include "FlowLock/Scheduler/FlowTask.h"
+#include <algorithm>
+
+namespace adapter {
+
+    bool PriorityTaskQueue::TaskComparator::operator()(const Entry& a, const Entry& b) const {
+        if (a.score != b.score) {
+            return a.score < b.score;  // Higher score = higher priority
+        }
+
+        return a.since > b.since;  // Waiting longer = higher priority
+    }
+
+    void PriorityTaskQueue::push(std::shared_ptr<FlowTask> task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pushLocked(std::move(task));
+        publishTop();
+    }
+
+    void PriorityTaskQueue::pushLocked(std::shared_ptr<FlowTask> task) {
+        double score = scoreOf(*task);
+        uint32_t priority = task->getEffectivePriority();
+        auto since = task->getWaitingSince();
+        tasks.push_back({ score, since, priority, std::move(task) });
+        std::push_heap(tasks.begin(), tasks.end(), TaskComparator());
+        countPriority(priority);
+    }
+
+    double PriorityTaskQueue::scoreOf(const FlowTask& task) const {
+        double score = task.getEffectivePriority();
+        if (agingInterval.count() > 0) {
+            std::chrono::duration<double, std::milli> queuedAt = task.getWaitingSince() - epoch;
+            score -= queuedAt.count() / agingInterval.count();
+        }
+        return score;
+    }
+
+    void PriorityTaskQueue::countPriority(uint32_t priority) {
+        priorityCounts[priority]++;
+    }
+
+    void PriorityTaskQueue::uncountPriority(uint32_t priority) {
+        auto it = priorityCounts.find(priority);
+        if (it != priorityCounts.end() && --it->second == 0) {
+            priorityCounts.erase(it);
+        }
+    }
+
+    void PriorityTaskQueue::promote(const FlowTask* task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = std::find_if(tasks.begin(), tasks.end(),
+            [task](const Entry& entry) { return entry.task.get() == task; });
+        if (it == tasks.end()) {
+            return;
+        }
+
+        uint32_t priority = it->task->getEffectivePriority();
+        if (priority != it->priority) {
+            uncountPriority(it->priority);
+            countPriority(priority);
+            it->priority = priority;
+        }
+
+        double score = scoreOf(*it->task);
+        if (score <= it->score) {
+            publishTop();
+            return;
+        }
+        it->score = score;
+        std::push_heap(tasks.begin(), it + 1, TaskComparator());
+        publishTop();
+    }
+
+    void PriorityTaskQueue::setAgingInterval(std::chrono::milliseconds interval) {
+        std::lock_guard<std::mutex> lock(mutex);
+        agingInterval = interval;
+    }
+
+    void PriorityTaskQueue::pushBulk(std::vector<std::shared_ptr<FlowTask>>& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& task : batch) {
+            if (task) {
+                pushLocked(std::move(task));
+            }
+        }
+        publishTop();
+    }
+
+    std::shared_ptr<FlowTask> PriorityTaskQueue::tryPop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) {
+            return nullptr;
+        }
+        return popHeadLocked();
+    }
+
+    std::shared_ptr<FlowTask> PriorityTaskQueue::tryPopAbove(const FlowTask& rival) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty() || tasks.front().score <= scoreOf(rival)) {
+            return nullptr;
+        }
+        return popHeadLocked();
+    }
+
+    std::shared_ptr<FlowTask> PriorityTaskQueue::popHeadLocked() {
+        std::pop_heap(tasks.begin(), tasks.end(), TaskComparator());
+        uncountPriority(tasks.back().priority);
+        auto task = std::move(tasks.back().task);
+        tasks.pop_back();
+        publishTop();
+        return task;
+    }
+
+    std::shared_ptr<FlowTask> PriorityTaskQueue::popLowestBelow(uint32_t priority) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Started tasks can sit anywhere in the heap, so the lowest unstarted one is
+        // not necessarily a leaf.
+        auto lowest = tasks.end();
+        for (auto it = tasks.begin(); it != tasks.end(); ++it) {
+            if (!it->task->hasStarted() && (lowest == tasks.end() || TaskComparator()(*it, *lowest))) {
+                lowest = it;
+            }
+        }
+        if (lowest == tasks.end() || lowest->task->getEffectivePriority() >= priority) {
+            return nullptr;
+        }
+
+        uncountPriority(lowest->priority);
+        auto task = std::move(lowest->task);
+        std::swap(*lowest, tasks.back());
+        tasks.pop_back();
+        std::make_heap(tasks.begin(), tasks.end(), TaskComparator());
+
+        publishTop();
+        return task;
+    }
+
+    size_t PriorityTaskQueue::size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tasks.size();
+    }
+
+    bool PriorityTaskQueue::hasPriorityAbove(uint32_t priority) const {
+        return topPriority.load(std::memory_order_relaxed) > static_cast<int64_t>(priority);
+    }
+
+    void PriorityTaskQueue::publishTop() {
+        topPriority.store(priorityCounts.empty() ? -1 : static_cast<int64_t>(priorityCounts.rbegin()->first),
+            std::memory_order_relaxed);
+    }
+
+} // namespace adapter
@@ -0,0 +1,69 @@
+#include "FlowLock/Scheduler/RingTaskQueue.h"
+#include "FlowLock/Scheduler/FlowTask.h"
+
+namespace adapter {
+
+    RingTaskQueue::RingTaskQueue(size_t capacity)
+        : ring(capacity) {
+    }
+
+    void RingTaskQueue::push(std::shared_ptr<FlowTask> task) {
+        if (!task) return;
+
+        // Counted before the push so a consumer never sees the task without its count.
+        count.fetch_add(1);
+
+        if (overflowCount.load(std::memory_order_acquire) == 0 && ring.tryPush(task)) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        overflow.push_back(std::move(task));
+        overflowCount.store(overflow.size(), std::memory_order_release);
+    }
+
+    std::shared_ptr<FlowTask> RingTaskQueue::tryPop() {
+        std::shared_ptr<FlowTask> task;
+        if (!ring.tryPop(task) && overflowCount.load(std::memory_order_acquire) != 0) {
+            task = popOverflow();
+        }
+
+        if (task) {
+            count.fetch_sub(1);
+        }
+        return task;
+    }
+
+    std::shared_ptr<FlowTask> RingTaskQueue::popOverflow() {
+        std::lock_guard<std::mutex> lock(overflowMutex);
+
+        std::shared_ptr<FlowTask> task;
+        if (ring.tryPop(task)) {
+            return task;
+        }
+        if (overflow.empty()) {
+            return nullptr;
+        }
+
+        task = std::move(overflow.front());
+        overflow.pop_front();
+
+        // Move the backlog into the ring while there is room so the queue returns to the
+        // lock-free path as soon as the overflow drains.
+        while (!overflow.empty() && ring.tryPush(overflow.front())) {
+            overflow.pop_front();
+        }
+        overflowCount.store(overflow.size(), std::memory_order_release);
+
+        return task;
+    }
+
+    size_t RingTaskQueue::size() const {
+        return count.load();
+    }
+
+    bool RingTaskQueue::hasPriorityAbove(uint32_t) const {
+        return false;  // Priorities are ignored in FIFO order
+    }
+
+} // namespace adapter
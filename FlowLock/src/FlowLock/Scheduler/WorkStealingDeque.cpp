@@ -0,0 +1,61 @@
+#include "FlowLock/Scheduler/WorkStealingDeque.h"
+#include "FlowLock/Scheduler/FlowTask.h"
+
+namespace adapter {
+
+    void WorkStealingDeque::pushBack(std::shared_ptr<FlowTask> task) {
+        if (!task) return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+        count.store(tasks.size(), std::memory_order_release);
+    }
+
+    void WorkStealingDeque::pushBack(std::vector<std::shared_ptr<FlowTask>>& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& task : batch) {
+            if (task) {
+                tasks.push_back(std::move(task));
+            }
+        }
+        count.store(tasks.size(), std::memory_order_release);
+    }
+
+    std::shared_ptr<FlowTask> WorkStealingDeque::popBack() {
+        if (count.load(std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) {
+            return nullptr;
+        }
+
+        auto task = std::move(tasks.back());
+        tasks.pop_back();
+        count.store(tasks.size(), std::memory_order_release);
+        return task;
+    }
+
+    std::shared_ptr<FlowTask> WorkStealingDeque::stealFront() {
+        // Thieves skip empty deques without touching the owner's mutex.
+        if (count.load(std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+        if (!lock.owns_lock() || tasks.empty()) {
+            return nullptr;
+        }
+
+        auto task = std::move(tasks.front());
+        tasks.pop_front();
+        count.store(tasks.size(), std::memory_order_release);
+        return task;
+    }
+
+    size_t WorkStealingDeque::size() const {
+        return count.load(std::memory_order_acquire);
+    }
+
+} // namespace adapter
@@ -21,12 +21,12 @@ FlowTracer::FlowTracer()
 void FlowTracer::recordTaskQueued(const std::shared_ptr<FlowTask>& task) {
     if (!enabled || !task) return;
 
-    addEvent(
+    appendEvent(
         TraceEvent::Type::TASK_QUEUED,
         "Task queued",
         nextTaskId++,
         std::nullopt,
-        task->getTags(),
+        task->getTagIds(),
         task->getPriority()
     );
 }
@@ -34,12 +34,12 @@ void FlowTracer::recordTaskQueued(const std::shared_ptr<FlowTask>& task) {
 void FlowTracer::recordTaskStarted(const std::shared_ptr<FlowTask>& task, const FlowContext& context) {
     if (!enabled || !task) return;
 
-    addEvent(
+    appendEvent(
         TraceEvent::Type::TASK_STARTED,
         "Task started",
         nextTaskId++,
         context.getThreadId(),
-        task->getTags(),
+        task->getTagIds(),
         task->getPriority()
     );
 }
@@ -58,12 +58,12 @@ void FlowTracer::recordTaskCompleted(const std::shared_ptr<FlowTask>& task, cons
         }
     }
 
-    addEvent(
+    appendEvent(
         TraceEvent::Type::TASK_COMPLETED,
         desc,
         nextTaskId++,
         context.getThreadId(),
-        task->getTags(),
+        task->getTagIds(),
         task->getPriority()
     );
 }
@@ -74,12 +74,12 @@ void FlowTracer::recordTaskFailed(const std::shared_ptr<FlowTask>& task, const F
     try {
         std::cerr << "Recording task failure: " << error << std::endl;
 
-        addEvent(
+        appendEvent(
             TraceEvent::Type::TASK_FAILED,
             "Task failed: " + error,
             nextTaskId++,
             context.getThreadId(),
-            task->getTags(),
+            task->getTagIds(),
             task->getPriority()
         );
     }
@@ -103,12 +103,12 @@ void FlowTracer::recordSchedulerEmpty() {
 void FlowTracer::recordConflictDetected(const std::shared_ptr<FlowTask>& task, const std::string& reason) {
     if (!enabled || !task) return;
 
-    addEvent(
+    appendEvent(
         TraceEvent::Type::CONFLICT_DETECTED,
         "Conflict detected: " + reason,
         nextTaskId++,
         std::nullopt,
-        task->getTags(),
+        task->getTagIds(),
         task->getPriority()
     );
 }
@@ -116,12 +116,12 @@ void FlowTracer::recordConflictDetected(const std::shared_ptr<FlowTask>& task, c
 void FlowTracer::recordTaskCancelled(const std::shared_ptr<FlowTask>& task) {
     if (!enabled || !task) return;
 
-    addEvent(
+    appendEvent(
         TraceEvent::Type::TASK_CANCELLED,
         "Task cancelled",
         nextTaskId++,
         std::nullopt,
-        task->getTags(),
+        task->getTagIds(),
         task->getPriority()
     );
 }
@@ -129,12 +129,12 @@ void FlowTracer::recordTaskCancelled(const std::shared_ptr<FlowTask>& task) {
 void FlowTracer::recordTaskTimedOut(const std::shared_ptr<FlowTask>& task) {
     if (!enabled || !task) return;
 
-    addEvent(
+    appendEvent(
         TraceEvent::Type::TASK_TIMED_OUT,
         "Task timed out",
         nextTaskId++,
         std::nullopt,
-        task->getTags(),
+        task->getTagIds(),
         task->getPriority()
     );
 }
@@ -144,12 +144,12 @@ void FlowTracer::recordAntiStarvationApplied(const std::shared_ptr<FlowTask>& ta
 
     std::string desc = "Anti-starvation applied after " + std::to_string(reenqueueCount) + " re-enqueues";
     
-    addEvent(
+    appendEvent(
         TraceEvent::Type::ANTI_STARVATION_APPLIED,
         desc,
         nextTaskId++,
         std::nullopt,
-        task->getTags(),
+        task->getTagIds(),
         task->getPriority()
     );
 }
@@ -161,6 +161,20 @@ void FlowTracer::addEvent(TraceEvent::Type type, const std::string& description,
     uint32_t priority) {
     if (!enabled) return;
 
+    std::vector<TagId> tagIds;
+    for (const auto& tag : tags) {
+        tagIds.push_back(TagRegistry::instance().intern(tag));
+    }
+    appendEvent(type, description, taskId, threadId, tagIds, priority);
+}
+
+void FlowTracer::appendEvent(TraceEvent::Type type, const std::string& description,
+    std::optional<uint32_t> taskId,
+    std::optional<uint32_t> threadId,
+    const std::vector<TagId>& tags,
+    uint32_t priority) {
+    if (!enabled) return;
+
     try {
         std::lock_guard<std::mutex> lock(mutex);
 
@@ -184,10 +198,10 @@ void FlowTracer::addEvent(TraceEvent::Type type, const std::string& description,
         }
     }
     catch (const std::exception& e) {
-        std::cerr << "Error in FlowTracer::addEvent: " << e.what() << std::endl;
+        std::cerr << "Error in FlowTracer::appendEvent: " << e.what() << std::endl;
     }
     catch (...) {
-        std::cerr << "Unknown error in FlowTracer::addEvent" << std::endl;
+        std::cerr << "Unknown error in FlowTracer::appendEvent" << std::endl;
     }
 }
 
@@ -267,12 +281,12 @@ std::string FlowTracer::toJson() const {
         
         ss << "\"tags\":[";
         bool firstTag = true;
-        for (const auto& tag : event.tags) {
+        for (TagId tag : event.tags) {
             if (!firstTag) {
                 ss << ",";
             }
             firstTag = false;
-            ss << "\"" << tag << "\"";
+            ss << "\"" << TagRegistry::instance().name(tag) << "\"";
         }
         ss << "]";
         
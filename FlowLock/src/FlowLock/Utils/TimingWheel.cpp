@@ -0,0 +1,199 @@
+#include "FlowLock/Utils/TimingWheel.h"
+#include <algorithm>
+#include <limits>
+
+namespace adapter {
+
+    TimingWheel::TimingWheel(std::chrono::milliseconds tick, Clock::time_point start)
+        : tick(tick.count() > 0 ? tick : std::chrono::milliseconds(1)), start(start) {
+    }
+
+    TimingWheel::TimerId TimingWheel::schedule(Clock::time_point when, Action action,
+        std::chrono::milliseconds period) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto entry = std::make_shared<Entry>();
+        entry->id = nextId++;
+        entry->expiry = std::max(toTick(when), currentTick + 1);
+        entry->period = period.count() > 0 ? std::max<uint64_t>(period / tick, 1) : 0;
+        entry->action = std::move(action);
+
+        live.emplace(entry->id, entry);
+        insert(std::move(entry));
+        return nextId - 1;
+    }
+
+    bool TimingWheel::cancel(TimerId id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = live.find(id);
+        if (it == live.end()) {
+            return false;
+        }
+
+        // The entry stays in its slot and is discarded when the wheel reaches it.
+        it->second->cancelled = true;
+        live.erase(it);
+        return true;
+    }
+
+    std::vector<TimingWheel::Action> TimingWheel::advance(Clock::time_point now) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Action> due;
+
+        uint64_t target = now > start ? static_cast<uint64_t>((now - start) / tick) : 0;
+        while (currentTick < target) {
+            uint64_t next = currentTick + 1;
+
+            // With the lower levels empty nothing happens before the next cascade of
+            // the first occupied level, so jump straight there.
+            size_t level = 0;
+            while (level < kLevels && levels[level].count == 0) {
+                level++;
+            }
+            if (level == kLevels) {
+                currentTick = target;
+                break;
+            }
+            if (level > 0) {
+                size_t shift = kSlotBits * level;
+                next = ((currentTick >> shift) + 1) << shift;
+            }
+            if (next > target) {
+                currentTick = target;
+                break;
+            }
+
+            currentTick = next;
+            for (size_t l = kLevels - 1; l > 0; --l) {
+                size_t shift = kSlotBits * l;
+                if ((currentTick & ((uint64_t(1) << shift) - 1)) == 0) {
+                    cascade(l, (currentTick >> shift) & (kSlots - 1));
+                }
+            }
+            expire(currentTick & (kSlots - 1), due);
+        }
+
+        return due;
+    }
+
+    std::optional<TimingWheel::Clock::time_point> TimingWheel::nextWakeup() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (live.empty()) {
+            return std::nullopt;
+        }
+
+        uint64_t wake = std::numeric_limits<uint64_t>::max();
+        if (levels[0].count > 0) {
+            for (uint64_t t = currentTick + 1; t <= currentTick + kSlots; ++t) {
+                size_t slot = t & (kSlots - 1);
+                if (levels[0].occupied[slot / 64] & (uint64_t(1) << (slot % 64))) {
+                    wake = t;
+                    break;
+                }
+            }
+        }
+
+        for (size_t l = 1; l < kLevels; ++l) {
+            if (levels[l].count > 0) {
+                size_t shift = kSlotBits * l;
+                wake = std::min(wake, ((currentTick >> shift) + 1) << shift);
+                break;
+            }
+        }
+
+        if (wake == std::numeric_limits<uint64_t>::max()) {
+            return std::nullopt;
+        }
+        return start + tick * wake;
+    }
+
+    size_t TimingWheel::size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return live.size();
+    }
+
+    uint64_t TimingWheel::toTick(Clock::time_point when) const {
+        if (when <= start) {
+            return 0;
+        }
+        // Round up so a timer never fires before its time.
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(when - start);
+        auto tickLength = std::chrono::duration_cast<std::chrono::nanoseconds>(tick);
+        return static_cast<uint64_t>((elapsed.count() + tickLength.count() - 1) / tickLength.count());
+    }
+
+    void TimingWheel::insert(std::shared_ptr<Entry> entry) {
+        uint64_t delta = entry->expiry > currentTick ? entry->expiry - currentTick : 0;
+
+        size_t level = 0;
+        while (level + 1 < kLevels && delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+            level++;
+        }
+
+        // Beyond the wheel's range the entry parks in the top level and is placed again
+        // when that slot cascades.
+        uint64_t placement = entry->expiry;
+        uint64_t maxDelta = (uint64_t(1) << (kSlotBits * kLevels)) - 1;
+        if (delta > maxDelta) {
+            placement = currentTick + maxDelta;
+        }
+
+        size_t slot = (placement >> (kSlotBits * level)) & (kSlots - 1);
+        Level& target = levels[level];
+        target.slots[slot].push_back(std::move(entry));
+        target.count++;
+        setOccupied(target, slot, true);
+    }
+
+    void TimingWheel::cascade(size_t level, size_t slot) {
+        Level& source = levels[level];
+        std::vector<std::shared_ptr<Entry>> entries;
+        entries.swap(source.slots[slot]);
+        source.count -= entries.size();
+        setOccupied(source, slot, false);
+
+        for (auto& entry : entries) {
+            if (!entry->cancelled) {
+                insert(std::move(entry));
+            }
+        }
+    }
+
+    void TimingWheel::expire(size_t slot, std::vector<Action>& due) {
+        Level& source = levels[0];
+        std::vector<std::shared_ptr<Entry>> entries;
+        entries.swap(source.slots[slot]);
+        source.count -= entries.size();
+        setOccupied(source, slot, false);
+
+        for (auto& entry : entries) {
+            if (entry->cancelled) {
+                continue;
+            }
+            if (entry->expiry > currentTick) {
+                insert(std::move(entry));
+                continue;
+            }
+
+            if (entry->period > 0) {
+                due.push_back(entry->action);
+                // A late wheel skips missed periods instead of firing a burst.
+                entry->expiry = std::max(entry->expiry + entry->period, currentTick + 1);
+                insert(std::move(entry));
+            } else {
+                due.push_back(std::move(entry->action));
+                live.erase(entry->id);
+            }
+        }
+    }
+
+    void TimingWheel::setOccupied(Level& level, size_t slot, bool occupied) {
+        uint64_t bit = uint64_t(1) << (slot % 64);
+        if (occupied) {
+            level.occupied[slot / 64] |= bit;
+        } else {
+            level.occupied[slot / 64] &= ~bit;
+        }
+    }
+
+} // namespace adapter
@@ -120,4 +120,399 @@ namespace adapter::Tests {
         EXPECT_TRUE(true);
     }
 
+    TEST_F(ConflictResolverTest, ParkedTaskIsHandedOverOnRelease) {
+        ConflictResolver resolver;
+        resolver.setPolicy("render", ConflictResolver::Policy::EXCLUSIVE);
+
+        auto holder = createTask({ "render" });
+        auto waiter = createTask({ "render" });
+
+        EXPECT_TRUE(resolver.tryAcquire(holder));
+        EXPECT_FALSE(resolver.tryAcquire(waiter));
+        EXPECT_EQ(resolver.getWaitingCount(), 1);
+
+        auto ready = resolver.release(holder);
+        ASSERT_EQ(ready.size(), 1);
+        EXPECT_EQ(ready[0], waiter);
+        EXPECT_EQ(resolver.getWaitingCount(), 0);
+
+        // The waiter already holds the tag, so nobody else can take it.
+        EXPECT_TRUE(resolver.tryAcquire(waiter));
+        EXPECT_FALSE(resolver.tryAcquire(createTask({ "render" })));
+    }
+
+    TEST_F(ConflictResolverTest, WaitersAreWokenByPriority) {
+        ConflictResolver resolver;
+        resolver.setPolicy("render", ConflictResolver::Policy::EXCLUSIVE);
+
+        auto holder = createTask({ "render" });
+        auto lowPriorityWaiter = createTask({ "render" }, 1);
+        auto highPriorityWaiter = createTask({ "render" }, 5);
+
+        EXPECT_TRUE(resolver.tryAcquire(holder));
+        EXPECT_FALSE(resolver.tryAcquire(lowPriorityWaiter));
+        EXPECT_FALSE(resolver.tryAcquire(highPriorityWaiter));
+
+        auto ready = resolver.release(holder);
+        ASSERT_EQ(ready.size(), 1);
+        EXPECT_EQ(ready[0], highPriorityWaiter);
+
+        ready = resolver.release(highPriorityWaiter);
+        ASSERT_EQ(ready.size(), 1);
+        EXPECT_EQ(ready[0], lowPriorityWaiter);
+    }
+
+    TEST_F(ConflictResolverTest, WaiterMovesToItsNextBlockingTag) {
+        ConflictResolver resolver;
+        resolver.setPolicy("render", ConflictResolver::Policy::EXCLUSIVE);
+        resolver.setPolicy("physics", ConflictResolver::Policy::EXCLUSIVE);
+
+        auto renderHolder = createTask({ "render" });
+        auto physicsHolder = createTask({ "physics" });
+        auto waiter = createTask({ "render", "physics" });
+
+        EXPECT_TRUE(resolver.tryAcquire(renderHolder));
+        EXPECT_TRUE(resolver.tryAcquire(physicsHolder));
+        EXPECT_FALSE(resolver.tryAcquire(waiter));
+
+        EXPECT_TRUE(resolver.release(renderHolder).empty());
+        EXPECT_EQ(resolver.getWaitingCount(), 1);
+
+        auto ready = resolver.release(physicsHolder);
+        ASSERT_EQ(ready.size(), 1);
+        EXPECT_EQ(ready[0], waiter);
+    }
+
+    TEST_F(ConflictResolverTest, AgedWaiterIsWokenFirst) {
+        ConflictResolver resolver;
+        resolver.setPolicy("render", ConflictResolver::Policy::EXCLUSIVE);
+        resolver.setAgingInterval(std::chrono::milliseconds(1));
+        auto now = std::chrono::steady_clock::now();
+
+        auto holder = createTask({ "render" });
+        auto oldWaiter = createTask({ "render" }, 1);
+        auto newWaiter = createTask({ "render" }, 40);
+        // Created long ago but only just parked: no credit for that time.
+        auto staleWaiter = std::make_shared<FlowTask>([](FlowContext&) {}, 30, now - std::chrono::seconds(10));
+        staleWaiter->addTag("render");
+
+        EXPECT_TRUE(resolver.tryAcquire(holder));
+        EXPECT_FALSE(resolver.tryAcquire(oldWaiter));
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        EXPECT_FALSE(resolver.tryAcquire(staleWaiter));
+        EXPECT_FALSE(resolver.tryAcquire(newWaiter));
+
+        auto ready = resolver.release(holder);
+        ASSERT_EQ(ready.size(), 1);
+        EXPECT_EQ(ready[0], oldWaiter);
+        ready = resolver.release(oldWaiter);
+        ASSERT_EQ(ready.size(), 1);
+        EXPECT_EQ(ready[0], newWaiter);
+    }
+
+    TEST_F(ConflictResolverTest, HolderInheritsPriorityOfParkedWaiter) {
+        ConflictResolver resolver;
+        resolver.setPolicy("device", ConflictResolver::Policy::EXCLUSIVE);
+
+        std::vector<const FlowTask*> boosted;
+        resolver.setPriorityBoostCallback([&boosted](const FlowTask* holder) { boosted.push_back(holder); });
+
+        auto holder = createTask({ "device" }, 1);
+        auto urgentWaiter = createTask({ "device" }, 90);
+        auto mildWaiter = createTask({ "device" }, 40);
+
+        EXPECT_TRUE(resolver.tryAcquire(holder));
+        EXPECT_FALSE(resolver.tryAcquire(urgentWaiter));
+        EXPECT_FALSE(resolver.tryAcquire(mildWaiter));
+
+        EXPECT_EQ(holder->getPriority(), 1u);
+        EXPECT_EQ(holder->getEffectivePriority(), 90u);
+        ASSERT_EQ(boosted.size(), 1u);
+        EXPECT_EQ(boosted[0], holder.get());
+
+        // The next holder inherits from the waiter still behind it.
+        auto ready = resolver.release(holder);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], urgentWaiter);
+        EXPECT_EQ(holder->getEffectivePriority(), 1u);
+        EXPECT_EQ(urgentWaiter->getEffectivePriority(), 90u);
+    }
+
+    TEST_F(ConflictResolverTest, UrgentWaiterPreemptsLowerPriorityHolder) {
+        ConflictResolver resolver;
+        resolver.setPolicy("physics", ConflictResolver::Policy::PRIORITY);
+
+        auto holder = createTask({ "physics" }, 1);
+        auto peer = createTask({ "physics" }, 1);
+        auto urgent = createTask({ "physics" }, 90);
+
+        EXPECT_TRUE(resolver.tryAcquire(holder));
+        EXPECT_FALSE(resolver.tryAcquire(peer));
+        EXPECT_FALSE(holder->isPreemptionRequested());
+
+        EXPECT_FALSE(resolver.tryAcquire(urgent));
+        EXPECT_TRUE(holder->isPreemptionRequested());
+
+        // The holder checkpoints: the tag goes to the urgent task and the holder waits again.
+        holder->clearPreemption();
+        auto ready = resolver.release(holder);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], urgent);
+        EXPECT_FALSE(resolver.tryAcquire(holder));
+        EXPECT_FALSE(urgent->isPreemptionRequested());
+    }
+
+    TEST_F(ConflictResolverTest, OccupancyTableTracksHolders) {
+        ConflictResolver resolver;
+        resolver.setPolicy("device", ConflictResolver::Policy::EXCLUSIVE);
+        TagId device = TagRegistry::instance().intern("device");
+        TagId audio = TagRegistry::instance().intern("audio");
+
+        auto holder = createTask({ "device", "audio" }, 7);
+        auto sharer = createTask({ "audio" }, 3);
+        auto contender = createTask({ "device" }, 1);
+
+        EXPECT_TRUE(resolver.canExecute(contender));
+        EXPECT_TRUE(resolver.tryAcquire(holder));
+        EXPECT_TRUE(resolver.tryAcquire(sharer));
+
+        EXPECT_EQ(resolver.getHolderCount(device), 1u);
+        EXPECT_EQ(resolver.getHolderCount(audio), 2u);
+        EXPECT_EQ(resolver.getMaxHolderPriority(audio), 7u);
+        EXPECT_FALSE(resolver.canExecute(contender));
+        EXPECT_TRUE(resolver.canExecute(createTask({ "audio" })));
+
+        resolver.release(holder);
+        EXPECT_EQ(resolver.getHolderCount(device), 0u);
+        EXPECT_EQ(resolver.getMaxHolderPriority(audio), 3u);
+        EXPECT_TRUE(resolver.canExecute(contender));
+    }
+
+    TEST_F(ConflictResolverTest, ConcurrentClaimsOnOverlappingTagsNeverCollide) {
+        ConflictResolver resolver;
+        const std::vector<std::string> names = { "stress:db", "stress:cache", "stress:log", "stress:index" };
+        std::vector<TagId> ids;
+        for (const auto& name : names) {
+            resolver.setPolicy(name, ConflictResolver::Policy::EXCLUSIVE);
+            ids.push_back(TagRegistry::instance().intern(name));
+        }
+
+        constexpr int kThreads = 8;
+        constexpr int kTasksPerThread = 300;
+        std::array<std::atomic<int>, 4> inUse{};
+        std::atomic<bool> collided{ false };
+        std::atomic<int> completed{ 0 };
+
+        auto worker = [&](int thread) {
+            std::vector<std::shared_ptr<FlowTask>> runnable;
+            for (int n = 0; n < kTasksPerThread; n++) {
+                auto task = createTask({ names[(thread + n) % 4], names[(thread + 2 * n + 1) % 4] });
+                if (resolver.tryAcquire(task)) {
+                    runnable.push_back(task);
+                }
+
+                // Run whatever this thread holds, including waiters handed over on release.
+                while (!runnable.empty()) {
+                    auto current = runnable.back();
+                    runnable.pop_back();
+                    for (size_t i = 0; i < ids.size(); i++) {
+                        if (current->hasTag(ids[i]) && ++inUse[i] != 1) collided = true;
+                    }
+                    std::this_thread::yield();
+                    for (size_t i = 0; i < ids.size(); i++) {
+                        if (current->hasTag(ids[i])) --inUse[i];
+                    }
+                    completed++;
+
+                    auto ready = resolver.release(current);
+                    runnable.insert(runnable.end(), ready.begin(), ready.end());
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; t++) {
+            threads.emplace_back(worker, t);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        EXPECT_FALSE(collided.load());
+        EXPECT_EQ(completed.load(), kThreads * kTasksPerThread);
+        EXPECT_EQ(resolver.getWaitingCount(), 0u);
+    }
+
+    TEST_F(ConflictResolverTest, ReadersShareTagWhileWriterWaitsItsTurn) {
+        ConflictResolver resolver;
+        resolver.setPolicy("cache", ConflictResolver::Policy::EXCLUSIVE);
+        TagId cache = TagRegistry::instance().intern("cache");
+
+        auto makeTask = [](TagId tag, TagAccess access) {
+            auto task = std::make_shared<FlowTask>([](FlowContext&) {});
+            task->addTag(tag, access);
+            return task;
+        };
+        auto reader1 = makeTask(cache, TagAccess::READ);
+        auto reader2 = makeTask(cache, TagAccess::READ);
+        auto writer = makeTask(cache, TagAccess::WRITE);
+        auto lateReader = makeTask(cache, TagAccess::READ);
+
+        EXPECT_TRUE(resolver.tryAcquire(reader1));
+        EXPECT_TRUE(resolver.tryAcquire(reader2));
+        EXPECT_EQ(resolver.getHolderCount(cache), 2u);
+
+        EXPECT_FALSE(resolver.tryAcquire(writer));
+        // Writer preference: a new reader queues behind the waiting writer.
+        EXPECT_FALSE(resolver.canExecute(lateReader));
+        EXPECT_FALSE(resolver.tryAcquire(lateReader));
+
+        EXPECT_TRUE(resolver.release(reader1).empty());
+        auto ready = resolver.release(reader2);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], writer);
+
+        ready = resolver.release(writer);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], lateReader);
+        EXPECT_EQ(resolver.getWaitingCount(), 0u);
+    }
+
+    TEST_F(ConflictResolverTest, LimitedTagAdmitsUpToItsLimit) {
+        ConflictResolver resolver;
+        resolver.setPolicy("pool", ConflictResolver::Policy::LIMITED, 2);
+        TagId pool = TagRegistry::instance().intern("pool");
+
+        auto first = createTask({ "pool" });
+        auto second = createTask({ "pool" });
+        auto third = createTask({ "pool" });
+        auto fourth = createTask({ "pool" });
+
+        EXPECT_TRUE(resolver.tryAcquire(first));
+        EXPECT_TRUE(resolver.tryAcquire(second));
+        EXPECT_FALSE(resolver.canExecute(third));
+        EXPECT_FALSE(resolver.tryAcquire(third));
+        EXPECT_FALSE(resolver.tryAcquire(fourth));
+        EXPECT_EQ(resolver.getHolderCount(pool), 2u);
+
+        auto ready = resolver.release(first);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], third);
+        EXPECT_EQ(resolver.getHolderCount(pool), 2u);
+
+        // Raising the limit lets the remaining waiter in at once.
+        ready = resolver.setPolicy("pool", ConflictResolver::Policy::LIMITED, 3);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], fourth);
+        EXPECT_EQ(resolver.getHolderCount(pool), 3u);
+        EXPECT_EQ(resolver.getWaitingCount(), 0u);
+
+        EXPECT_THROW(resolver.setPolicy("pool", ConflictResolver::Policy::LIMITED, 0), std::runtime_error);
+    }
+
+    TEST_F(ConflictResolverTest, RateLimitedTagWaitsForRefill) {
+        ConflictResolver resolver;
+        TagId api = TagRegistry::instance().intern("api");
+        std::vector<std::chrono::steady_clock::time_point> refills;
+        resolver.setRefillCallback([&](TagId tag, std::chrono::steady_clock::time_point when) {
+            EXPECT_EQ(tag, api);
+            refills.push_back(when);
+        });
+        resolver.setRateLimit("api", 2, std::chrono::milliseconds(40));
+
+        auto first = createTask({ "api" });
+        auto second = createTask({ "api" });
+        auto third = createTask({ "api" });
+        auto fourth = createTask({ "api" });
+
+        // The burst goes through at once, even after the holders are gone.
+        EXPECT_TRUE(resolver.tryAcquire(first));
+        EXPECT_TRUE(resolver.tryAcquire(second));
+        resolver.release(first);
+        resolver.release(second);
+        EXPECT_FALSE(resolver.canExecute(third));
+        EXPECT_FALSE(resolver.tryAcquire(third));
+        EXPECT_FALSE(resolver.tryAcquire(fourth));
+        ASSERT_EQ(refills.size(), 1u);
+
+        std::this_thread::sleep_until(refills[0]);
+        auto ready = resolver.refill(api);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], third);
+        ASSERT_EQ(refills.size(), 2u);
+        EXPECT_GT(refills[1], refills[0]);
+
+        std::this_thread::sleep_until(refills[1]);
+        ready = resolver.refill(api);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], fourth);
+        EXPECT_EQ(resolver.getWaitingCount(), 0u);
+    }
+
+    TEST_F(ConflictResolverTest, ExclusiveTagCoversItsSubtree) {
+        ConflictResolver resolver;
+        resolver.setPolicy("db/users", ConflictResolver::Policy::EXCLUSIVE);
+        resolver.setPolicy("db/users/42", ConflictResolver::Policy::EXCLUSIVE);
+
+        auto row = createTask({ "db/users/42" });
+        auto otherRow = createTask({ "db/users/7" });
+        auto table = createTask({ "db/users" });
+        auto sibling = createTask({ "db/orders/1" });
+        auto laterRow = createTask({ "db/users/9" });
+
+        EXPECT_TRUE(resolver.tryAcquire(row));
+        EXPECT_TRUE(resolver.tryAcquire(otherRow));
+        EXPECT_FALSE(resolver.canExecute(table));
+        EXPECT_FALSE(resolver.tryAcquire(table));
+        EXPECT_TRUE(resolver.tryAcquire(sibling));
+        // Queues behind the table writer rather than starving it.
+        EXPECT_FALSE(resolver.tryAcquire(laterRow));
+
+        EXPECT_TRUE(resolver.release(row).empty());
+        auto ready = resolver.release(otherRow);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], table);
+
+        ready = resolver.release(table);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], laterRow);
+        EXPECT_EQ(resolver.getWaitingCount(), 0u);
+    }
+
+    TEST_F(ConflictResolverTest, RepeatedPolicyUpdateChangesNothing) {
+        ConflictResolver resolver;
+        TagId queue = TagRegistry::instance().intern("queue");
+        resolver.setPolicy("queue", ConflictResolver::Policy::EXCLUSIVE, 4);
+        EXPECT_EQ(resolver.getLimit(queue), 1u);  // Only LIMITED keeps its limit
+        resolver.setPolicy("queue", ConflictResolver::Policy::LIMITED, 1);
+
+        auto holder = createTask({ "queue" });
+        auto waiter = createTask({ "queue" });
+        EXPECT_TRUE(resolver.tryAcquire(holder));
+        EXPECT_FALSE(resolver.tryAcquire(waiter));
+
+        EXPECT_TRUE(resolver.setPolicy("queue", ConflictResolver::Policy::LIMITED, 1).empty());
+        EXPECT_EQ(resolver.getWaitingCount(), 1u);
+
+        auto ready = resolver.setPolicy("queue", ConflictResolver::Policy::LIMITED, 2);
+        ASSERT_EQ(ready.size(), 1u);
+        EXPECT_EQ(ready[0], waiter);
+        EXPECT_EQ(resolver.getPolicy(queue), ConflictResolver::Policy::LIMITED);
+        EXPECT_EQ(resolver.getLimit(queue), 2u);
+    }
+
+    TEST_F(ConflictResolverTest, TagIdsBeyondTheFirstMillionHaveState) {
+        ConflictResolver resolver;
+        TagId far = 5'000'000;
+        TagId last = std::numeric_limits<TagId>::max();
+
+        resolver.setPolicy(far, ConflictResolver::Policy::LIMITED, 3);
+        resolver.setPolicy(last, ConflictResolver::Policy::EXCLUSIVE);
+
+        EXPECT_EQ(resolver.getPolicy(far), ConflictResolver::Policy::LIMITED);
+        EXPECT_EQ(resolver.getLimit(far), 3u);
+        EXPECT_EQ(resolver.getPolicy(last), ConflictResolver::Policy::EXCLUSIVE);
+        EXPECT_EQ(resolver.getPolicy(far + 1), ConflictResolver::Policy::SHARED);
+    }
+
 }  // namespace adapter::Tests
\ No newline at end of file
@@ -66,4 +66,57 @@ namespace adapter::Tests {
         EXPECT_GE(actualDuration, expectedDuration - marginOfError);
     }
 
+    TEST_F(FlowContextTest, TimeoutStopsContinuation) {
+        FlowContext context(1, 1);
+
+        EXPECT_TRUE(context.shouldContinue());
+
+        context.setTimeout(std::chrono::milliseconds(5));
+        EXPECT_FALSE(context.isTimedOut());
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_TRUE(context.isTimedOut());
+        EXPECT_FALSE(context.shouldContinue());
+    }
+
+    TEST_F(FlowContextTest, CancellationStopsContinuation) {
+        FlowContext context(1, 1);
+
+        EXPECT_FALSE(context.isCancellationRequested());
+
+        context.requestCancellation();
+        EXPECT_TRUE(context.isCancellationRequested());
+        EXPECT_FALSE(context.shouldContinue());
+    }
+
+    TEST_F(FlowContextTest, YieldIsRequestedAndSuggested) {
+        FlowContext context(1, 1);
+
+        EXPECT_FALSE(context.hasYielded());
+        EXPECT_FALSE(context.shouldYield());
+
+        bool urgentWorkWaiting = false;
+        context.setYieldCheck([&urgentWorkWaiting] { return urgentWorkWaiting; });
+        EXPECT_FALSE(context.shouldYield());
+        urgentWorkWaiting = true;
+        EXPECT_TRUE(context.shouldYield());
+
+        context.yield();
+        EXPECT_TRUE(context.hasYielded());
+    }
+
+    TEST_F(FlowContextTest, PreemptionStopsContinuationAndSuggestsYield) {
+        FlowContext context(1, 1);
+        std::atomic<bool> preempted{ false };
+        context.bindPreemption(&preempted);
+
+        EXPECT_TRUE(context.shouldContinue());
+        EXPECT_FALSE(context.shouldYield());
+
+        preempted = true;
+        EXPECT_TRUE(context.isPreemptionRequested());
+        EXPECT_FALSE(context.shouldContinue());
+        EXPECT_TRUE(context.shouldYield());
+    }
+
 }  // namespace adapter::Tests
\ No newline at end of file
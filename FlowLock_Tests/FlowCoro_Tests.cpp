@@ -0,0 +1,193 @@
+#include "pch.h"
+
+#ifdef FLOWLOCK_HAS_COROUTINES
+
+namespace adapter::Tests {
+
+    class FlowCoroTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            FlowTracer::instance().setEnabled(false);
+            FlowLockImpl::instance().setThreadPoolSize(2);
+        }
+
+        void TearDown() override {
+            FlowLockImpl::instance().await();
+            FlowTracer::instance().setEnabled(true);
+        }
+    };
+
+    FlowCoro<int> square(int value) {
+        co_await schedule();
+        co_return value * value;
+    }
+
+    FlowCoro<int> sumOfSquares(int count) {
+        int sum = 0;
+        for (int i = 1; i <= count; i++) {
+            sum += co_await square(i);
+        }
+        co_return sum;
+    }
+
+    TEST_F(FlowCoroTest, NestedCoroutinesReturnValues) {
+        auto future = spawn(sumOfSquares(10));
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_EQ(future.get(), 385);
+    }
+
+    TEST_F(FlowCoroTest, SleepDoesNotHoldAWorker) {
+        std::vector<std::future<void>> sleepers;
+        auto sleeper = []() -> FlowCoro<void> {
+            co_await sleepFor(std::chrono::milliseconds(50));
+        };
+        // More sleepers than workers: they only finish together if none pins a thread.
+        for (int i = 0; i < 8; i++) {
+            sleepers.push_back(spawn(sleeper()));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto& future : sleepers) {
+            ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        }
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(300));
+    }
+
+    TEST_F(FlowCoroTest, AwaitsTasksAndFutures) {
+        auto pipeline = []() -> FlowCoro<int> {
+            int decoded = co_await runAsync([](FlowContext&) { return 20; });
+            auto pending = FlowLockImpl::instance().request([](FlowContext&) { return 2; });
+            int scale = co_await pending;
+            co_return decoded * scale;
+        };
+
+        auto future = spawn(pipeline());
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_EQ(future.get(), 40);
+    }
+
+    TEST_F(FlowCoroTest, ExceptionsReachTheSpawnFuture) {
+        auto failing = []() -> FlowCoro<void> {
+            co_await runAsync([](FlowContext&) { throw std::runtime_error("decode failed"); });
+        };
+
+        auto future = spawn(failing());
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_THROW(future.get(), std::runtime_error);
+    }
+
+    FlowCoro<void> useDevice(std::atomic<int>& inside, std::atomic<int>& maxInside) {
+        std::vector<std::string> tags = { "device" };
+        co_await acquireTags(tags);
+        int now = ++inside;
+        int seen = maxInside.load();
+        while (now > seen && !maxInside.compare_exchange_weak(seen, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        --inside;
+    }
+
+    TEST_F(FlowCoroTest, AcquiredTagsAreExclusiveUntilNextSuspension) {
+        FlowLockImpl::instance().setPolicy("device", ConflictResolver::Policy::EXCLUSIVE);
+        std::atomic<int> inside{ 0 };
+        std::atomic<int> maxInside{ 0 };
+
+        std::vector<std::future<void>> users;
+        for (int i = 0; i < 6; i++) {
+            users.push_back(spawn(useDevice(inside, maxInside)));
+        }
+        for (auto& future : users) {
+            future.get();
+        }
+        EXPECT_EQ(maxInside.load(), 1);
+    }
+
+    TEST_F(FlowCoroTest, AwaitingAHandleDoesNotPoll) {
+        auto waiter = []() -> FlowCoro<int> {
+            auto slow = FlowLockImpl::instance().request([](FlowContext&) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                return 7;
+            });
+            co_return co_await slow;
+        };
+
+        size_t completedBefore = FlowLockImpl::instance().stats().completedTaskCount;
+        auto future = spawn(waiter());
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_EQ(future.get(), 7);
+
+        // The start, the awaited task and one resume; a 1 ms poll would add ~200 checks.
+        EXPECT_LT(FlowLockImpl::instance().stats().completedTaskCount - completedBefore, 10u);
+    }
+
+    TEST_F(FlowCoroTest, ResumeRejectedOnTheTimerThreadThrowsInsteadOfBlocking) {
+        auto& flowLock = FlowLockImpl::instance();
+        flowLock.setThreadPoolSize(1);
+
+        std::atomic<bool> suspended{ false };
+        auto waiter = [&suspended]() -> FlowCoro<int> {
+            auto delayed = FlowLockImpl::instance().runAfter(std::chrono::milliseconds(100),
+                [](FlowContext&) { return 1; });
+            suspended = true;
+            co_return co_await delayed;
+        };
+        auto future = spawn(waiter());
+        while (!suspended) std::this_thread::yield();
+
+        // Pin the only worker and fill the queue, so both the delayed task and the
+        // coroutine's resume are rejected when the timer fires.
+        std::promise<void> gate;
+        std::shared_future<void> opened = gate.get_future().share();
+        std::atomic<bool> pinned{ false };
+        auto blocker = flowLock.request([opened, &pinned](FlowContext&) {
+            pinned = true;
+            opened.wait();
+        });
+        while (!pinned) std::this_thread::yield();
+        flowLock.setQueueCapacity(1, FlowScheduler::OverflowPolicy::REJECT);
+        auto filler = flowLock.request([](FlowContext&) {});
+
+        auto status = future.wait_for(std::chrono::seconds(2));
+        gate.set_value();
+        flowLock.setQueueCapacity(0);
+        blocker.get();
+        filler.get();
+        flowLock.setThreadPoolSize(2);
+
+        ASSERT_EQ(status, std::future_status::ready);
+        try {
+            future.get();
+            ADD_FAILURE() << "expected the rejection to reach the coroutine";
+        } catch (const std::runtime_error& error) {
+            EXPECT_NE(std::string(error.what()).find("queue is full"), std::string::npos);
+        }
+    }
+
+    TEST_F(FlowCoroTest, CancellingAFinishedAwaitedTaskLeavesTheResumeAlone) {
+        auto& flowLock = FlowLockImpl::instance();
+        constexpr uint32_t kAwaitedPriority = 7;
+
+        // The completion callback runs after the awaited task has set its result and
+        // submitted the coroutine's resume, while the task is still alive: the same
+        // window in which a late FlowHandle::cancel() would reach it.
+        flowLock.setTaskCompletionCallback([](const std::shared_ptr<FlowTask>& task) {
+            if (task->getPriority() == kAwaitedPriority) {
+                task->cancel();
+            }
+        });
+
+        auto waiter = []() -> FlowCoro<int> {
+            auto handle = FlowLockImpl::instance().request([](FlowContext&) { return 3; }, kAwaitedPriority);
+            co_return co_await handle;
+        };
+        auto future = spawn(waiter());
+
+        auto status = future.wait_for(std::chrono::seconds(5));
+        flowLock.await();
+        flowLock.setTaskCompletionCallback(nullptr);
+        ASSERT_EQ(status, std::future_status::ready);
+        EXPECT_EQ(future.get(), 3);
+    }
+
+}  // namespace adapter::Tests
+
+#endif
\ No newline at end of file
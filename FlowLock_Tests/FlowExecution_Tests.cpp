@@ -97,4 +97,27 @@ namespace adapter::Tests {
         EXPECT_TRUE(execution->getRunningTasks().empty());
     }
 
+    TEST_F(FlowExecutionTest, YieldedTaskIsHandedBackInsteadOfCompleted) {
+        int chunksLeft = 3;
+        auto task = std::make_shared<FlowTask>([&chunksLeft](FlowContext& ctx) {
+            if (--chunksLeft > 0) {
+                ctx.yield();
+            }
+        });
+
+        int yieldedCount = 0;
+        int completedCount = 0;
+        execution->setTaskYieldedCallback([&](const std::shared_ptr<FlowTask>&) { yieldedCount++; });
+        execution->setTaskCompletionCallback([&](const std::shared_ptr<FlowTask>&) { completedCount++; });
+
+        while (completedCount == 0) {
+            execution->executeTask(task);
+        }
+
+        EXPECT_EQ(chunksLeft, 0);
+        EXPECT_EQ(yieldedCount, 2);
+        EXPECT_EQ(completedCount, 1);
+        EXPECT_TRUE(execution->getRunningTasks().empty());
+    }
+
 }  // namespace adapter::Tests
\ No newline at end of file
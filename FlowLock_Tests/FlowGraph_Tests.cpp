@@ -0,0 +1,95 @@
+#include "pch.h"
+
+namespace adapter::Tests {
+
+    class FlowGraphTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            FlowTracer::instance().setEnabled(false);
+            FlowLockImpl::instance().setThreadPoolSize(4);
+        }
+
+        void TearDown() override {
+            FlowLockImpl::instance().await();
+            FlowTracer::instance().setEnabled(true);
+        }
+    };
+
+    TEST_F(FlowGraphTest, NodesRunAfterTheirPredecessors) {
+        std::mutex orderMutex;
+        std::vector<std::string> order;
+        auto record = [&](const std::string& name) {
+            return [&, name](FlowContext&) {
+                std::lock_guard<std::mutex> lock(orderMutex);
+                order.push_back(name);
+            };
+        };
+
+        FlowGraph graph;
+        auto decode = graph.addNode(record("decode"));
+        auto left = graph.addNode(record("left"));
+        auto right = graph.addNode(record("right"));
+        auto encode = graph.addNode(record("encode"));
+        graph.precede(decode, left);
+        graph.precede(decode, right);
+        graph.dependsOn(encode, { left, right });
+
+        ASSERT_EQ(graph.submit().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+        ASSERT_EQ(order.size(), 4u);
+        EXPECT_EQ(order.front(), "decode");
+        EXPECT_EQ(order.back(), "encode");
+    }
+
+    TEST_F(FlowGraphTest, FailureSkipsDependentsAndReachesTheFuture) {
+        std::atomic<int> runCount{ 0 };
+
+        FlowGraph graph;
+        auto source = graph.addNode([&](FlowContext&) { runCount++; });
+        auto failing = graph.addNode([&](FlowContext&) {
+            runCount++;
+            throw std::runtime_error("transform failed");
+        });
+        auto dependent = graph.addNode([&](FlowContext&) { runCount++; });
+        auto independent = graph.addNode([&](FlowContext&) { runCount++; });
+        graph.precede(source, failing);
+        graph.precede(failing, dependent);
+        graph.precede(source, independent);
+
+        auto future = graph.submit();
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_THROW(future.get(), std::runtime_error);
+        EXPECT_EQ(runCount.load(), 3);
+    }
+
+    TEST_F(FlowGraphTest, CyclesAreRejected) {
+        FlowGraph graph;
+        auto first = graph.addNode([](FlowContext&) {});
+        auto second = graph.addNode([](FlowContext&) {});
+        graph.precede(first, second);
+        graph.precede(second, first);
+
+        EXPECT_THROW(graph.submit(), std::runtime_error);
+        EXPECT_THROW(graph.precede(first, 7), std::runtime_error);
+    }
+
+    TEST_F(FlowGraphTest, GraphCanBeSubmittedRepeatedly) {
+        std::atomic<int> total{ 0 };
+
+        FlowGraph graph;
+        auto previous = graph.addNode([&](FlowContext&) { total++; });
+        for (int i = 0; i < 20; i++) {
+            auto next = graph.addNode([&](FlowContext&) { total++; });
+            graph.precede(previous, next);
+            previous = next;
+        }
+
+        auto first = graph.submit();
+        auto second = graph.submit();
+        first.get();
+        second.get();
+
+        EXPECT_EQ(total.load(), 42);
+    }
+
+}  // namespace adapter::Tests
\ No newline at end of file
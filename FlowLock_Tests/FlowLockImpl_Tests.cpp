@@ -0,0 +1,364 @@
+#include "pch.h"
+
+namespace adapter::Tests {
+
+    class FlowLockImplTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            FlowTracer::instance().setEnabled(false);
+            FlowLockImpl::instance().setThreadPoolSize(4);
+        }
+
+        void TearDown() override {
+            if (pinned.valid()) {
+                unpinWorker();
+            }
+            FlowLockImpl::instance().setQueueCapacity(0);
+            FlowLockImpl::instance().await();
+            FlowLockImpl::instance().setAntiStarvationLimit(10);
+            FlowTracer::instance().setEnabled(true);
+        }
+
+        // Keeps the only worker busy, so submitted tasks stay queued until unpinWorker().
+        void pinOnlyWorker() {
+            FlowLockImpl::instance().setThreadPoolSize(1);
+            std::promise<void> started;
+            pinned = FlowLockImpl::instance().request([&started, opened = gate.get_future().share()](FlowContext&) {
+                started.set_value();
+                opened.wait();
+            });
+            started.get_future().wait();
+        }
+
+        void unpinWorker() {
+            gate.set_value();
+            pinned.get();
+        }
+
+        void expectFailure(std::future<void>& future, const std::string& reason) {
+            ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+            try {
+                future.get();
+                ADD_FAILURE() << "task ran instead of failing with: " << reason;
+            } catch (const std::runtime_error& e) {
+                EXPECT_NE(std::string(e.what()).find(reason), std::string::npos) << e.what();
+            }
+        }
+
+        std::promise<void> gate;
+        std::future<void> pinned;
+    };
+
+    TEST_F(FlowLockImplTest, YieldedJobLetsUrgentTaskRunBeforeItsNextChunk) {
+        auto& flowLock = FlowLockImpl::instance();
+        flowLock.setThreadPoolSize(1);
+        flowLock.setAntiStarvationLimit(1);  // One level per 10 ms
+
+        std::atomic<int> chunks{ 0 };
+        std::atomic<int> chunksBeforeUrgent{ -1 };
+        auto job = flowLock.requestResumable([&](FlowContext&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            return ++chunks < 100 ? StepResult::CONTINUE : StepResult::DONE;
+        }, 0);
+
+        // By now the job was created 30 levels' worth ago; it must still yield to the
+        // urgent task, as each chunk is queued afresh.
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        int submittedAt = chunks;
+        auto urgent = flowLock.request([&](FlowContext&) { chunksBeforeUrgent = chunks.load(); }, 20);
+
+        ASSERT_EQ(urgent.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_LE(chunksBeforeUrgent.load(), submittedAt + 1);
+        job.get();
+    }
+
+    TEST_F(FlowLockImplTest, ExpiredChildOnLocalDequeFailsItsFuture) {
+        FlowLockImpl::instance().setThreadPoolSize(1);  // Nobody to steal the child
+        std::promise<std::future<void>> childFuture;
+        auto parent = FlowBuilder().run([&](FlowContext&) {
+            // Stays on this worker's deque while the parent keeps the worker busy.
+            childFuture.set_value(FlowBuilder().withTimeout(std::chrono::milliseconds(10)).run([](FlowContext&) {}));
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        });
+        parent.get();
+
+        auto child = childFuture.get_future().get();
+        ASSERT_EQ(child.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        try {
+            child.get();
+            FAIL() << "expired task ran";
+        } catch (const std::runtime_error& e) {
+            EXPECT_NE(std::string(e.what()).find("deadline expired"), std::string::npos);
+        }
+    }
+
+    TEST_F(FlowLockImplTest, DelayedTasksDoNotRunEarly) {
+        auto& flowLock = FlowLockImpl::instance();
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = [start](FlowContext&) { return std::chrono::steady_clock::now() - start; };
+
+        auto afterDelay = flowLock.runAfter(std::chrono::milliseconds(50), elapsed);
+        auto atTime = flowLock.runAt(start + std::chrono::milliseconds(80), elapsed);
+        auto built = FlowBuilder().withDelay(std::chrono::milliseconds(60)).run(elapsed);
+
+        ASSERT_EQ(atTime.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_GE(afterDelay.get(), std::chrono::milliseconds(50));
+        EXPECT_GE(atTime.get(), std::chrono::milliseconds(80));
+        EXPECT_GE(built.get(), std::chrono::milliseconds(60));
+    }
+
+    TEST_F(FlowLockImplTest, DelayedTasksDoNotHoldAWorker) {
+        auto& flowLock = FlowLockImpl::instance();
+        flowLock.setThreadPoolSize(1);
+
+        std::vector<std::future<int>> delayed;
+        for (int i = 0; i < 4; i++) {
+            delayed.push_back(flowLock.runAfter(std::chrono::milliseconds(200), [i](FlowContext&) { return i; }));
+        }
+        delayed.push_back(FlowBuilder().withDelay(std::chrono::milliseconds(200)).run([](FlowContext&) { return 4; }));
+
+        // The only worker is free while they wait, so immediate work goes straight through.
+        auto start = std::chrono::steady_clock::now();
+        auto immediate = flowLock.request([](FlowContext&) { return 42; });
+        ASSERT_EQ(immediate.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(150));
+        EXPECT_EQ(immediate.get(), 42);
+        EXPECT_EQ(delayed[0].wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+
+        for (int i = 0; i < 5; i++) {
+            EXPECT_EQ(delayed[i].get(), i);
+        }
+    }
+
+    TEST_F(FlowLockImplTest, CancelTimerStopsRunEvery) {
+        auto& flowLock = FlowLockImpl::instance();
+        std::atomic<int> ticks{ 0 };
+
+        auto id = flowLock.runEvery(std::chrono::milliseconds(5), [&ticks](FlowContext&) { ++ticks; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        EXPECT_TRUE(flowLock.cancelTimer(id));
+        EXPECT_FALSE(flowLock.cancelTimer(id));
+
+        // A tick the wheel handed out just before the cancel may still be submitted.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        flowLock.await();
+        int ticksAtCancel = ticks;
+        EXPECT_GT(ticksAtCancel, 1);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        flowLock.await();
+        EXPECT_EQ(ticks.load(), ticksAtCancel);
+    }
+
+    TEST_F(FlowLockImplTest, BlockedSubmitterFailsAfterTheTimeout) {
+        auto& flowLock = FlowLockImpl::instance();
+        pinOnlyWorker();
+        flowLock.setQueueCapacity(1, FlowScheduler::OverflowPolicy::BLOCK, std::chrono::milliseconds(50));
+        auto queued = flowLock.request([](FlowContext&) {});
+
+        auto start = std::chrono::steady_clock::now();
+        std::future<void> blocked = flowLock.request([](FlowContext&) {});
+        EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(45));
+        expectFailure(blocked, "scheduler queue is full");
+
+        unpinWorker();
+        queued.get();
+    }
+
+    TEST_F(FlowLockImplTest, BlockedSubmitterGetsInOnceRoomFrees) {
+        auto& flowLock = FlowLockImpl::instance();
+        pinOnlyWorker();
+        flowLock.setQueueCapacity(1, FlowScheduler::OverflowPolicy::BLOCK, std::chrono::seconds(5));
+        auto queued = flowLock.request([](FlowContext&) {});
+
+        std::thread releaser([this] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            unpinWorker();
+        });
+        auto admitted = flowLock.request([](FlowContext&) { return 7; });
+        releaser.join();
+
+        EXPECT_EQ(admitted.get(), 7);
+        queued.get();
+    }
+
+    TEST_F(FlowLockImplTest, RejectFailsTheNewcomerAtOnce) {
+        auto& flowLock = FlowLockImpl::instance();
+        pinOnlyWorker();
+        flowLock.setQueueCapacity(1, FlowScheduler::OverflowPolicy::REJECT);
+        auto queued = flowLock.request([](FlowContext&) {});
+
+        std::future<void> rejected = flowLock.request([](FlowContext&) {});
+        EXPECT_EQ(rejected.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+        expectFailure(rejected, "scheduler queue is full");
+
+        unpinWorker();
+        queued.get();
+    }
+
+    TEST_F(FlowLockImplTest, ShedLowestDropsTheLeastUrgentQueuedTask) {
+        auto& flowLock = FlowLockImpl::instance();
+        pinOnlyWorker();
+        flowLock.setQueueCapacity(2, FlowScheduler::OverflowPolicy::SHED_LOWEST);
+        std::future<void> low = flowLock.request([](FlowContext&) {}, 1);
+        auto middle = flowLock.request([](FlowContext&) { return 5; }, 5);
+
+        auto urgent = flowLock.request([](FlowContext&) { return 9; }, 9);
+        expectFailure(low, "shed to admit higher-priority work");
+
+        // Nothing queued ranks below it, so the least urgent newcomer is the one refused.
+        std::future<void> lowest = flowLock.request([](FlowContext&) {}, 0);
+        expectFailure(lowest, "scheduler queue is full");
+
+        unpinWorker();
+        EXPECT_EQ(middle.get(), 5);
+        EXPECT_EQ(urgent.get(), 9);
+    }
+
+    TEST_F(FlowLockImplTest, TrySubmitReturnsNulloptInsteadOfWaiting) {
+        auto& flowLock = FlowLockImpl::instance();
+        pinOnlyWorker();
+        flowLock.setQueueCapacity(1, FlowScheduler::OverflowPolicy::BLOCK, std::chrono::seconds(5));
+
+        auto accepted = flowLock.tryRequest([](FlowContext&) { return 1; });
+        ASSERT_TRUE(accepted.has_value());
+
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_FALSE(flowLock.tryRequest([](FlowContext&) { return 2; }).has_value());
+        EXPECT_FALSE(FlowLock::tryRun([](FlowContext&) { return 3; }).has_value());
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+        unpinWorker();
+        EXPECT_EQ(accepted->get(), 1);
+    }
+
+    TEST_F(FlowLockImplTest, BatchesFromLvalueRangesLeaveTheCallablesUsable) {
+        std::vector<std::function<int(FlowContext&)>> funcs;
+        for (int i = 0; i < 16; i++) {
+            funcs.push_back([i](FlowContext&) { return i * i; });
+        }
+
+        auto requested = FlowLockImpl::instance().requestBatch(funcs, 3);
+        auto built = FlowBuilder().withPriority(3).runAll(funcs);
+
+        ASSERT_EQ(requested.size(), funcs.size());
+        ASSERT_EQ(built.size(), funcs.size());
+        for (int i = 0; i < 16; i++) {
+            EXPECT_EQ(requested[i].get(), i * i);
+            EXPECT_EQ(built[i].get(), i * i);
+            EXPECT_TRUE(funcs[i]);
+        }
+    }
+
+    TEST_F(FlowLockImplTest, BatchesFromRvalueRangesReturnEveryValue) {
+        auto makeFuncs = []() {
+            std::vector<std::function<std::string(FlowContext&)>> funcs;
+            for (int i = 0; i < 16; i++) {
+                funcs.push_back([label = "task " + std::to_string(i)](FlowContext&) { return label; });
+            }
+            return funcs;
+        };
+
+        auto requested = FlowLockImpl::instance().requestBatch(makeFuncs());
+        auto built = FlowBuilder().runAll(makeFuncs());
+
+        ASSERT_EQ(requested.size(), 16u);
+        ASSERT_EQ(built.size(), 16u);
+        for (int i = 0; i < 16; i++) {
+            EXPECT_EQ(requested[i].get(), "task " + std::to_string(i));
+            EXPECT_EQ(built[i].get(), "task " + std::to_string(i));
+        }
+    }
+
+    TEST_F(FlowLockImplTest, BatchHandlesCancelTheirOwnTask) {
+        pinOnlyWorker();
+        std::vector<std::function<void(FlowContext&)>> funcs(3, [](FlowContext&) {});
+        auto handles = FlowBuilder().runAll(funcs);
+
+        handles[1].cancel();
+        EXPECT_TRUE(handles[1].isCancelled());
+        unpinWorker();
+
+        handles[0].get();
+        EXPECT_THROW(handles[1].get(), std::runtime_error);
+        handles[2].get();
+    }
+
+    TEST_F(FlowLockImplTest, StarvedTaskKeepsItsCreditAgainstLocalWork) {
+        auto& flowLock = FlowLockImpl::instance();
+        flowLock.setThreadPoolSize(1);
+        flowLock.setAntiStarvationLimit(1);  // One level per 10 ms
+
+        std::mutex orderMutex;
+        std::vector<std::string> order;
+        auto record = [&](const char* name) {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(name);
+        };
+
+        std::promise<void> started;
+        std::promise<void> release;
+        std::future<void> local;
+        auto parent = flowLock.request([&, released = release.get_future().share()](FlowContext&) {
+            started.set_value();
+            released.wait();
+            local = flowLock.request([&](FlowContext&) { record("local"); }, 5);  // This worker's deque
+        });
+        started.get_future().wait();
+
+        auto starved = flowLock.request([&](FlowContext&) { record("starved"); }, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));  // About 30 levels of credit
+        // Outranks the local task by raw priority, so the worker looks at the queue.
+        auto urgent = flowLock.request([&](FlowContext&) { record("urgent"); }, 9);
+        release.set_value();
+
+        parent.get();
+        starved.get();
+        urgent.get();
+        local.get();
+        ASSERT_EQ(order.size(), 3u);
+        EXPECT_EQ(order[0], "starved");
+    }
+
+    TEST_F(FlowLockImplTest, ShedLowestSparesAJobQueuedBetweenChunks) {
+        auto& flowLock = FlowLockImpl::instance();
+        flowLock.setThreadPoolSize(1);
+
+        std::promise<void> firstChunk;
+        std::promise<void> finishFirstChunk;
+        std::atomic<int> chunks{ 0 };
+        auto job = flowLock.requestResumable([&, finish = finishFirstChunk.get_future().share()](FlowContext&) {
+            if (++chunks == 1) {
+                firstChunk.set_value();
+                finish.wait();
+                return StepResult::CONTINUE;
+            }
+            return StepResult::DONE;
+        }, 0);
+        firstChunk.get_future().wait();
+
+        // The blocker outranks the job, so once the first chunk yields the job waits in
+        // the queue, started, while the blocker holds the only worker.
+        std::promise<void> blockerStarted;
+        std::promise<void> unblock;
+        auto blocker = flowLock.request([&, opened = unblock.get_future().share()](FlowContext&) {
+            blockerStarted.set_value();
+            opened.wait();
+        }, 2);
+        finishFirstChunk.set_value();
+        blockerStarted.get_future().wait();
+
+        flowLock.setQueueCapacity(1, FlowScheduler::OverflowPolicy::SHED_LOWEST);
+        std::future<void> filler = flowLock.request([](FlowContext&) {}, 1);
+        auto urgent = flowLock.request([](FlowContext&) { return 5; }, 5);
+
+        // The job holds no admission slot, so the filler is the one that makes room.
+        expectFailure(filler, "shed to admit higher-priority work");
+        unblock.set_value();
+        blocker.get();
+        EXPECT_EQ(urgent.get(), 5);
+        job.get();
+        EXPECT_EQ(chunks.load(), 2);
+    }
+
+}  // namespace adapter::Tests
\ No newline at end of file
@@ -81,4 +81,406 @@ namespace adapter::Tests {
         EXPECT_EQ(task, nullptr);
     }
 
+    TEST_F(FlowSchedulerTest, EnqueueTasksInsertsWholeBatch) {
+        FlowScheduler scheduler;
+
+        std::vector<std::shared_ptr<FlowTask>> batch;
+        for (uint32_t priority = 0; priority < 5; priority++) {
+            batch.push_back(std::make_shared<FlowTask>([](FlowContext&) {}, priority));
+        }
+        auto highest = batch.back();
+
+        scheduler.enqueueTasks(batch);
+
+        EXPECT_EQ(scheduler.getQueueSize(), 5);
+        EXPECT_EQ(scheduler.dequeueTask(), highest);
+    }
+
+    TEST_F(FlowSchedulerTest, PriorityBandsOrderByPriority) {
+        FlowScheduler scheduler(FlowScheduler::Strategy::PRIORITY_BANDS);
+
+        auto lowPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 10);
+        auto highPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 20);
+        auto topPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 5000);
+
+        scheduler.enqueueTask(lowPriorityTask);
+        scheduler.enqueueTask(topPriorityTask);
+        scheduler.enqueueTask(highPriorityTask);
+
+        EXPECT_EQ(scheduler.getQueueSize(), 3);
+        EXPECT_EQ(scheduler.dequeueTask(), topPriorityTask);
+        EXPECT_EQ(scheduler.dequeueTask(), highPriorityTask);
+        EXPECT_EQ(scheduler.dequeueTask(), lowPriorityTask);
+        EXPECT_FALSE(scheduler.hasTasks());
+    }
+
+    TEST_F(FlowSchedulerTest, PriorityBandsKeepFifoWithinBand) {
+        FlowScheduler scheduler(FlowScheduler::Strategy::PRIORITY_BANDS);
+
+        std::vector<std::shared_ptr<FlowTask>> tasks;
+        for (int i = 0; i < 2000; i++) {
+            tasks.push_back(std::make_shared<FlowTask>([](FlowContext&) {}, 7));
+            scheduler.enqueueTask(tasks.back());
+        }
+
+        for (const auto& task : tasks) {
+            EXPECT_EQ(scheduler.dequeueTask(), task);
+        }
+    }
+
+    TEST_F(FlowSchedulerTest, PriorityBandsConcurrentProducersAndConsumers) {
+        FlowScheduler scheduler(FlowScheduler::Strategy::PRIORITY_BANDS);
+        const int producers = 4;
+        const int tasksPerProducer = 5000;
+        std::atomic<int> dequeued{ 0 };
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&scheduler, p]() {
+                for (int i = 0; i < tasksPerProducer; i++) {
+                    scheduler.enqueueTask(std::make_shared<FlowTask>([](FlowContext&) {}, (p * 31 + i) % 200));
+                }
+                });
+        }
+        for (int c = 0; c < producers; c++) {
+            threads.emplace_back([&scheduler, &dequeued]() {
+                while (dequeued < producers * tasksPerProducer) {
+                    if (scheduler.dequeueTask()) {
+                        dequeued++;
+                    }
+                }
+                });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        EXPECT_EQ(dequeued, producers * tasksPerProducer);
+        EXPECT_FALSE(scheduler.hasTasks());
+    }
+
+    TEST_F(FlowSchedulerTest, FifoIgnoresPriority) {
+        FlowScheduler scheduler(FlowScheduler::Strategy::FIFO);
+
+        auto lowPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 10);
+        auto highPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 20);
+
+        scheduler.enqueueTask(lowPriorityTask);
+        scheduler.enqueueTask(highPriorityTask);
+
+        EXPECT_EQ(scheduler.dequeueTask(), lowPriorityTask);
+        EXPECT_EQ(scheduler.dequeueTask(), highPriorityTask);
+    }
+
+    TEST_F(FlowSchedulerTest, FifoKeepsOrderPastRingCapacity) {
+        FlowScheduler scheduler(FlowScheduler::Strategy::FIFO);
+
+        std::vector<std::shared_ptr<FlowTask>> tasks;
+        for (int i = 0; i < 20000; i++) {
+            tasks.push_back(std::make_shared<FlowTask>([](FlowContext&) {}));
+            scheduler.enqueueTask(tasks.back());
+        }
+        EXPECT_EQ(scheduler.getQueueSize(), tasks.size());
+
+        for (const auto& task : tasks) {
+            ASSERT_EQ(scheduler.dequeueTask(), task);
+        }
+        EXPECT_FALSE(scheduler.hasTasks());
+    }
+
+    TEST_F(FlowSchedulerTest, SwitchingStrategyUnderLoadLosesNoTask) {
+        FlowScheduler scheduler(FlowScheduler::Strategy::FIFO);
+        const int producers = 3;
+        const int tasksPerProducer = 5000;
+        std::atomic<int> dequeued{ 0 };
+        std::atomic<bool> switching{ true };
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&scheduler]() {
+                for (int i = 0; i < tasksPerProducer; i++) {
+                    scheduler.enqueueTask(std::make_shared<FlowTask>([](FlowContext&) {}, i % 64));
+                }
+                });
+        }
+        threads.emplace_back([&scheduler, &dequeued]() {
+            while (dequeued < producers * tasksPerProducer) {
+                if (scheduler.dequeueTask()) {
+                    dequeued++;
+                }
+            }
+            });
+        std::thread switcher([&scheduler, &switching]() {
+            const FlowScheduler::Strategy strategies[] = {
+                FlowScheduler::Strategy::PRIORITY,
+                FlowScheduler::Strategy::PRIORITY_BANDS,
+                FlowScheduler::Strategy::FIFO
+            };
+            for (int i = 0; switching; i++) {
+                scheduler.setStrategy(strategies[i % 3]);
+            }
+            });
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        switching = false;
+        switcher.join();
+
+        EXPECT_EQ(dequeued, producers * tasksPerProducer);
+        EXPECT_FALSE(scheduler.hasTasks());
+    }
+
+    TEST_F(FlowSchedulerTest, SetStrategyKeepsQueuedTasks) {
+        FlowScheduler scheduler;
+
+        auto lowPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 1);
+        auto highPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 2);
+        scheduler.enqueueTask(lowPriorityTask);
+        scheduler.enqueueTask(highPriorityTask);
+
+        scheduler.setStrategy(FlowScheduler::Strategy::PRIORITY_BANDS);
+        EXPECT_EQ(scheduler.getStrategy(), FlowScheduler::Strategy::PRIORITY_BANDS);
+        EXPECT_EQ(scheduler.getQueueSize(), 2);
+
+        EXPECT_EQ(scheduler.dequeueTask(), highPriorityTask);
+        EXPECT_EQ(scheduler.dequeueTask(), lowPriorityTask);
+    }
+
+    TEST_F(FlowSchedulerTest, WaitForWorkWakesParkedConsumers) {
+        FlowScheduler scheduler;
+        const int consumers = 4;
+        std::atomic<int> dequeued{ 0 };
+        std::atomic<bool> done{ false };
+
+        std::vector<std::thread> threads;
+        for (int c = 0; c < consumers; c++) {
+            threads.emplace_back([&scheduler, &dequeued, &done]() {
+                while (!done) {
+                    if (scheduler.dequeueTask()) {
+                        dequeued++;
+                        continue;
+                    }
+                    scheduler.waitForWork([&]() { return done || scheduler.hasTasks(); });
+                }
+                });
+        }
+
+        for (int i = 0; i < 100; i++) {
+            scheduler.enqueueTask(std::make_shared<FlowTask>([](FlowContext&) {}));
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (dequeued < 100 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        done = true;
+        scheduler.wakeAll();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        EXPECT_EQ(dequeued, 100);
+    }
+
+    TEST_F(FlowSchedulerTest, DeadlineRunsEarliestDeadlineFirst) {
+        FlowScheduler scheduler(FlowScheduler::Strategy::DEADLINE);
+        auto now = std::chrono::steady_clock::now();
+
+        auto noDeadlineTask = std::make_shared<FlowTask>([](FlowContext&) {}, 50);
+        auto lateTask = std::make_shared<FlowTask>([](FlowContext&) {}, 10);
+        lateTask->setDeadline(now + std::chrono::seconds(20));
+        auto soonTask = std::make_shared<FlowTask>([](FlowContext&) {}, 1);
+        soonTask->setDeadline(now + std::chrono::seconds(10));
+        auto soonHighPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 5);
+        soonHighPriorityTask->setDeadline(now + std::chrono::seconds(10));
+
+        scheduler.enqueueTask(noDeadlineTask);
+        scheduler.enqueueTask(lateTask);
+        scheduler.enqueueTask(soonTask);
+        scheduler.enqueueTask(soonHighPriorityTask);
+
+        EXPECT_EQ(scheduler.dequeueTask(), soonHighPriorityTask);
+        EXPECT_EQ(scheduler.dequeueTask(), soonTask);
+        EXPECT_EQ(scheduler.dequeueTask(), lateTask);
+        EXPECT_EQ(scheduler.dequeueTask(), noDeadlineTask);
+    }
+
+    TEST_F(FlowSchedulerTest, ExpiredTasksAreDroppedAtDequeue) {
+        FlowScheduler scheduler(FlowScheduler::Strategy::DEADLINE);
+        std::vector<std::shared_ptr<FlowTask>> dropped;
+        scheduler.setTaskDroppedCallback([&dropped](const std::shared_ptr<FlowTask>& task) {
+            dropped.push_back(task);
+        });
+
+        bool abandoned = false;
+        auto expiredTask = std::make_shared<FlowTask>([](FlowContext&) {});
+        expiredTask->setDeadline(std::chrono::steady_clock::now() - std::chrono::milliseconds(1));
+        expiredTask->setAbandonHandler([&abandoned](std::exception_ptr) { abandoned = true; });
+        auto liveTask = std::make_shared<FlowTask>([](FlowContext&) {});
+
+        scheduler.enqueueTask(expiredTask);
+        scheduler.enqueueTask(liveTask);
+
+        EXPECT_EQ(scheduler.dequeueTask(), liveTask);
+        EXPECT_TRUE(abandoned);
+        ASSERT_EQ(dropped.size(), 1);
+        EXPECT_EQ(dropped[0], expiredTask);
+        EXPECT_FALSE(scheduler.hasTasks());
+    }
+
+    TEST_F(FlowSchedulerTest, FairSharesDispatchesByWeight) {
+        FlowScheduler scheduler(FlowScheduler::Strategy::FAIR);
+        scheduler.setFairShareWeight("render", 3);
+
+        // A burst from one tenant must not starve the other.
+        for (int i = 0; i < 40; i++) {
+            auto task = std::make_shared<FlowTask>([](FlowContext&) {}, 100);
+            task->setTenant("noisy");
+            scheduler.enqueueTask(task);
+        }
+        for (int i = 0; i < 40; i++) {
+            auto task = std::make_shared<FlowTask>([](FlowContext&) {});
+            task->addTag("render");
+            scheduler.enqueueTask(task);
+        }
+
+        int renderCount = 0;
+        for (int i = 0; i < 40; i++) {
+            auto task = scheduler.dequeueTask();
+            ASSERT_NE(task, nullptr);
+            if (task->hasTag("render")) {
+                renderCount++;
+            }
+        }
+
+        EXPECT_EQ(renderCount, 30);
+        EXPECT_EQ(scheduler.getQueueSize(), 40);
+    }
+
+    TEST_F(FlowSchedulerTest, AgingLetsLongWaitingTasksOvertake) {
+        FlowScheduler scheduler;
+        scheduler.setAgingInterval(std::chrono::milliseconds(1));
+
+        // 60 ms in the queue is worth at least 60 priority levels.
+        auto oldLowPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 1);
+        scheduler.enqueueTask(oldLowPriorityTask);
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+        auto newHighPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 50);
+        auto newTopPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 200);
+        scheduler.enqueueTask(newHighPriorityTask);
+        scheduler.enqueueTask(newTopPriorityTask);
+
+        // The aged head does not hide the higher priorities queued behind it.
+        EXPECT_TRUE(scheduler.hasTaskAbove(100));
+        EXPECT_EQ(scheduler.dequeueTask(), newTopPriorityTask);
+        EXPECT_TRUE(scheduler.hasTaskAbove(40));
+        EXPECT_EQ(scheduler.dequeueTask(), oldLowPriorityTask);
+        EXPECT_EQ(scheduler.dequeueTask(), newHighPriorityTask);
+        EXPECT_FALSE(scheduler.hasTaskAbove(0));
+    }
+
+    TEST_F(FlowSchedulerTest, AgingCountsFromEnqueueNotCreation) {
+        FlowScheduler scheduler;
+        scheduler.setAgingInterval(std::chrono::milliseconds(10));
+        auto now = std::chrono::steady_clock::now();
+
+        // Created long ago (e.g. held in a timer or running before a yield), queued just now.
+        auto oldLowPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 1, now - std::chrono::seconds(10));
+        auto newHighPriorityTask = std::make_shared<FlowTask>([](FlowContext&) {}, 50, now);
+
+        scheduler.enqueueTask(oldLowPriorityTask);
+        scheduler.enqueueTask(newHighPriorityTask);
+
+        EXPECT_EQ(scheduler.dequeueTask(), newHighPriorityTask);
+        EXPECT_EQ(scheduler.dequeueTask(), oldLowPriorityTask);
+    }
+
+    TEST_F(FlowSchedulerTest, CapacityRejectsOnceFull) {
+        FlowScheduler scheduler;
+        scheduler.setCapacity(2, FlowScheduler::OverflowPolicy::REJECT);
+
+        auto task = std::make_shared<FlowTask>([](FlowContext&) {});
+        EXPECT_TRUE(scheduler.admit(task));
+        EXPECT_TRUE(scheduler.admit(task));
+        EXPECT_FALSE(scheduler.admit(task));
+        EXPECT_FALSE(scheduler.tryAdmit());
+
+        scheduler.releaseAdmission();
+        EXPECT_TRUE(scheduler.tryAdmit());
+    }
+
+    TEST_F(FlowSchedulerTest, ShedLowestDropsLeastUrgentQueuedTask) {
+        for (auto strategy : { FlowScheduler::Strategy::PRIORITY, FlowScheduler::Strategy::PRIORITY_BANDS }) {
+            FlowScheduler scheduler(strategy);
+            scheduler.setCapacity(3, FlowScheduler::OverflowPolicy::SHED_LOWEST);
+
+            std::vector<std::shared_ptr<FlowTask>> dropped;
+            scheduler.setTaskDroppedCallback([&](const std::shared_ptr<FlowTask>& task) {
+                dropped.push_back(task);
+                scheduler.releaseAdmission();
+            });
+
+            for (uint32_t priority : { 40u, 5u, 20u }) {
+                auto task = std::make_shared<FlowTask>([](FlowContext&) {}, priority);
+                ASSERT_TRUE(scheduler.admit(task));
+                scheduler.enqueueTask(task);
+            }
+
+            // Nothing queued ranks below priority 5, so the newcomer is refused.
+            EXPECT_FALSE(scheduler.admit(std::make_shared<FlowTask>([](FlowContext&) {}, 5)));
+            EXPECT_TRUE(dropped.empty());
+
+            auto urgent = std::make_shared<FlowTask>([](FlowContext&) {}, 60);
+            ASSERT_TRUE(scheduler.admit(urgent));
+            scheduler.enqueueTask(urgent);
+
+            ASSERT_EQ(dropped.size(), 1u);
+            EXPECT_EQ(dropped[0]->getPriority(), 5u);
+            EXPECT_EQ(scheduler.getQueueSize(), 3u);
+            EXPECT_FALSE(scheduler.tryAdmit());
+            EXPECT_EQ(scheduler.dequeueTask(), urgent);
+        }
+    }
+
+    TEST_F(FlowSchedulerTest, CancelledTasksAreDroppedAtDequeue) {
+        FlowScheduler scheduler;
+
+        std::vector<std::shared_ptr<FlowTask>> dropped;
+        scheduler.setTaskDroppedCallback([&dropped](const std::shared_ptr<FlowTask>& task) {
+            dropped.push_back(task);
+        });
+
+        auto cancelledTask = std::make_shared<FlowTask>([](FlowContext&) {}, 10);
+        auto liveTask = std::make_shared<FlowTask>([](FlowContext&) {}, 1);
+        scheduler.enqueueTask(cancelledTask);
+        scheduler.enqueueTask(liveTask);
+
+        cancelledTask->cancel();
+
+        EXPECT_EQ(scheduler.dequeueTask(), liveTask);
+        ASSERT_EQ(dropped.size(), 1u);
+        EXPECT_EQ(dropped[0], cancelledTask);
+    }
+
+    TEST_F(FlowSchedulerTest, PromotedTaskMovesUpTheQueue) {
+        FlowScheduler scheduler;
+
+        auto holder = std::make_shared<FlowTask>([](FlowContext&) {}, 1);
+        auto medium = std::make_shared<FlowTask>([](FlowContext&) {}, 20);
+        auto other = std::make_shared<FlowTask>([](FlowContext&) {}, 10);
+        scheduler.enqueueTask(holder);
+        scheduler.enqueueTask(medium);
+        scheduler.enqueueTask(other);
+
+        holder->inheritPriority(50);
+        scheduler.promote(holder.get());
+
+        EXPECT_TRUE(scheduler.hasTaskAbove(20));
+        EXPECT_EQ(scheduler.dequeueTask(), holder);
+        EXPECT_EQ(scheduler.dequeueTask(), medium);
+        EXPECT_EQ(scheduler.dequeueTask(), other);
+    }
+
 }  // namespace adapter::Tests
\ No newline at end of file
@@ -64,4 +64,61 @@ namespace adapter::Tests {
         EXPECT_EQ(capturedLogicalTick, 123);
     }
 
+    TEST_F(FlowTaskTest, CancelBeforeStartAbandonsInsteadOfRunning) {
+        bool executed = false;
+        FlowTask task([&executed](FlowContext&) { executed = true; });
+
+        std::exception_ptr reason;
+        task.setAbandonHandler([&reason](std::exception_ptr r) { reason = r; });
+
+        task.cancel();
+        FlowContext context(1, 1);
+        task.execute(context);
+
+        EXPECT_TRUE(task.isCancelled());
+        EXPECT_FALSE(executed);
+        EXPECT_FALSE(task.hasStarted());
+        EXPECT_NE(reason, nullptr);
+    }
+
+    TEST_F(FlowTaskTest, CancelReachesRunningTaskAndItsChildren) {
+        auto child = std::make_shared<FlowTask>([](FlowContext&) {});
+        bool sawCancellation = false;
+
+        std::shared_ptr<FlowTask> parent;
+        parent = std::make_shared<FlowTask>([&](FlowContext& ctx) {
+            ASSERT_EQ(FlowTask::current(), parent.get());
+            FlowTask::current()->adoptChild(child);
+            EXPECT_TRUE(ctx.shouldContinue());
+
+            parent->cancel();
+            sawCancellation = !ctx.shouldContinue();
+        });
+
+        FlowContext context(1, 1);
+        parent->execute(context);
+
+        EXPECT_TRUE(sawCancellation);
+        EXPECT_TRUE(child->isCancelled());
+        EXPECT_EQ(FlowTask::current(), nullptr);
+
+        auto lateChild = std::make_shared<FlowTask>([](FlowContext&) {});
+        parent->adoptChild(lateChild);
+        EXPECT_TRUE(lateChild->isCancelled());
+    }
+
+    TEST_F(FlowTaskTest, RepeatedTagKeepsStrongerAccess) {
+        auto task = std::make_shared<FlowTask>([](FlowContext&) {});
+        TagId tag = TagRegistry::instance().intern("state");
+
+        EXPECT_EQ(task->getTagAccess(tag), TagAccess::DEFAULT);
+        task->addTag(tag, TagAccess::READ);
+        task->addTag("state");
+        EXPECT_EQ(task->getTagAccess(tag), TagAccess::READ);
+        task->addTag("state", TagAccess::WRITE);
+        task->addTag(tag, TagAccess::READ);
+        EXPECT_EQ(task->getTagAccess(tag), TagAccess::WRITE);
+        EXPECT_EQ(task->getTagIds().size(), 1u);
+    }
+
 }  // namespace adapter::Tests
\ No newline at end of file
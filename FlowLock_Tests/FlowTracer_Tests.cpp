@@ -80,8 +80,8 @@ namespace adapter::Tests {
         EXPECT_TRUE(events[0].threadId.has_value());
         EXPECT_EQ(events[0].threadId.value(), 123);
         EXPECT_EQ(events[0].tags.size(), 2);
-        EXPECT_EQ(events[0].tags[0], "render");
-        EXPECT_EQ(events[0].tags[1], "physics");
+        EXPECT_EQ(TagRegistry::instance().name(events[0].tags[0]), "render");
+        EXPECT_EQ(TagRegistry::instance().name(events[0].tags[1]), "physics");
     }
 
     TEST_F(FlowTracerTest, RecordTaskLifecycle) {
@@ -0,0 +1,71 @@
+#include "pch.h"
+
+namespace adapter::Tests {
+
+    class TagRegistryTest : public ::testing::Test {
+    };
+
+    TEST_F(TagRegistryTest, InterningIsStableAndReversible) {
+        auto& registry = TagRegistry::instance();
+
+        TagId audio = registry.intern("registry:audio");
+        TagId video = registry.intern("registry:video");
+
+        EXPECT_NE(audio, video);
+        EXPECT_EQ(registry.intern("registry:audio"), audio);
+        EXPECT_EQ(registry.name(video), "registry:video");
+        EXPECT_EQ(registry.find("registry:audio"), audio);
+        EXPECT_FALSE(registry.find("registry:never-used").has_value());
+        EXPECT_THROW(registry.name(static_cast<TagId>(registry.size())), std::runtime_error);
+    }
+
+    TEST_F(TagRegistryTest, TasksStoreInternedIds) {
+        FlowTask task([](FlowContext&) {});
+        task.addTag("registry:render");
+        task.addTag(TagRegistry::instance().intern("registry:render"));
+
+        ASSERT_EQ(task.getTagIds().size(), 1u);
+        EXPECT_TRUE(task.hasTag(TagRegistry::instance().intern("registry:render")));
+        EXPECT_FALSE(task.hasTag("registry:physics"));
+        EXPECT_EQ(task.getTags(), std::vector<std::string>{ "registry:render" });
+    }
+
+    TEST_F(TagRegistryTest, ConcurrentInterningAgreesOnIds) {
+        std::vector<std::thread> threads;
+        std::vector<std::vector<TagId>> seen(4);
+        for (size_t t = 0; t < seen.size(); t++) {
+            threads.emplace_back([&seen, t] {
+                for (int i = 0; i < 100; i++) {
+                    seen[t].push_back(TagRegistry::instance().intern("registry:shard/" + std::to_string(i)));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (size_t t = 1; t < seen.size(); t++) {
+            EXPECT_EQ(seen[t], seen[0]);
+        }
+    }
+
+    TEST_F(TagRegistryTest, PathsInternTheirAncestors) {
+        auto& registry = TagRegistry::instance();
+
+        TagId row = registry.intern("registry:db/users/42");
+        auto table = registry.find("registry:db/users");
+        auto database = registry.find("registry:db");
+
+        ASSERT_TRUE(table.has_value());
+        ASSERT_TRUE(database.has_value());
+        EXPECT_EQ(registry.parent(row), table);
+        EXPECT_FALSE(registry.parent(*database).has_value());
+        EXPECT_EQ(registry.ancestors(row), (std::vector<TagId>{ *table, *database }));
+
+        FlowTask task([](FlowContext&) {});
+        task.addTag(row);
+        EXPECT_EQ(task.getSortedTagIds(), std::vector<TagId>{ row });
+        EXPECT_EQ(task.getSortedLockIds(), (std::vector<TagId>{ *database, *table, row }));
+    }
+
+}  // namespace adapter::Tests
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "pch.h"
+
+namespace adapter::Tests {
+
+    class TimingWheelTest : public ::testing::Test {
+    protected:
+        using Clock = TimingWheel::Clock;
+
+        Clock::time_point start = Clock::now();
+
+        Clock::time_point at(int64_t milliseconds) const {
+            return start + std::chrono::milliseconds(milliseconds);
+        }
+
+        static void runAll(const std::vector<TimingWheel::Action>& actions) {
+            for (const auto& action : actions) {
+                action();
+            }
+        }
+    };
+
+    TEST_F(TimingWheelTest, FiresWhenDue) {
+        TimingWheel wheel(std::chrono::milliseconds(1), start);
+        int fired = 0;
+        wheel.schedule(at(5), [&fired]() { fired++; });
+
+        EXPECT_TRUE(wheel.advance(at(4)).empty());
+        runAll(wheel.advance(at(5)));
+        EXPECT_EQ(fired, 1);
+        EXPECT_EQ(wheel.size(), 0);
+    }
+
+    TEST_F(TimingWheelTest, FiresInOrderAcrossLevels) {
+        TimingWheel wheel(std::chrono::milliseconds(1), start);
+        std::vector<int> fired;
+        wheel.schedule(at(70000), [&fired]() { fired.push_back(3); });
+        wheel.schedule(at(300), [&fired]() { fired.push_back(2); });
+        wheel.schedule(at(10), [&fired]() { fired.push_back(1); });
+
+        EXPECT_EQ(wheel.nextWakeup(), at(10));
+        for (int64_t now = 0; now < 70000; now += 100) {
+            runAll(wheel.advance(at(now)));
+        }
+        runAll(wheel.advance(at(69999)));
+        EXPECT_EQ(fired, (std::vector<int>{ 1, 2 }));
+
+        runAll(wheel.advance(at(70000)));
+        EXPECT_EQ(fired, (std::vector<int>{ 1, 2, 3 }));
+    }
+
+    TEST_F(TimingWheelTest, LongJumpFiresEverythingDue) {
+        TimingWheel wheel(std::chrono::milliseconds(1), start);
+        int fired = 0;
+        for (int64_t delay : { 1, 255, 256, 65536, 5000000 }) {
+            wheel.schedule(at(delay), [&fired]() { fired++; });
+        }
+
+        runAll(wheel.advance(at(4999999)));
+        EXPECT_EQ(fired, 4);
+        runAll(wheel.advance(at(5000000)));
+        EXPECT_EQ(fired, 5);
+    }
+
+    TEST_F(TimingWheelTest, CancelledTimerDoesNotFire) {
+        TimingWheel wheel(std::chrono::milliseconds(1), start);
+        int fired = 0;
+        auto id = wheel.schedule(at(20), [&fired]() { fired++; });
+
+        EXPECT_TRUE(wheel.cancel(id));
+        EXPECT_FALSE(wheel.cancel(id));
+        runAll(wheel.advance(at(100)));
+        EXPECT_EQ(fired, 0);
+    }
+
+    TEST_F(TimingWheelTest, RecurringTimerRearms) {
+        TimingWheel wheel(std::chrono::milliseconds(1), start);
+        int fired = 0;
+        auto id = wheel.schedule(at(10), [&fired]() { fired++; }, std::chrono::milliseconds(10));
+
+        for (int64_t now = 1; now <= 50; now++) {
+            runAll(wheel.advance(at(now)));
+        }
+        EXPECT_EQ(fired, 5);
+
+        wheel.cancel(id);
+        runAll(wheel.advance(at(100)));
+        EXPECT_EQ(fired, 5);
+    }
+
+}  // namespace adapter::Tests
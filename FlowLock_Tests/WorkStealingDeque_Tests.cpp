@@ -0,0 +1,75 @@
+#include "pch.h"
+
+namespace adapter::Tests {
+
+    class WorkStealingDequeTest : public ::testing::Test {
+    protected:
+        std::shared_ptr<FlowTask> createTask(uint32_t priority = 0) {
+            return std::make_shared<FlowTask>([](FlowContext&) {}, priority);
+        }
+    };
+
+    TEST_F(WorkStealingDequeTest, OwnerPopsLastPushed) {
+        WorkStealingDeque deque;
+
+        auto first = createTask();
+        auto second = createTask();
+        deque.pushBack(first);
+        deque.pushBack(second);
+
+        EXPECT_EQ(deque.size(), 2);
+        EXPECT_EQ(deque.popBack(), second);
+        EXPECT_EQ(deque.popBack(), first);
+        EXPECT_EQ(deque.popBack(), nullptr);
+        EXPECT_TRUE(deque.empty());
+    }
+
+    TEST_F(WorkStealingDequeTest, ThiefStealsOldest) {
+        WorkStealingDeque deque;
+
+        auto first = createTask();
+        auto second = createTask();
+        deque.pushBack(first);
+        deque.pushBack(second);
+
+        EXPECT_EQ(deque.stealFront(), first);
+        EXPECT_EQ(deque.popBack(), second);
+        EXPECT_EQ(deque.stealFront(), nullptr);
+    }
+
+    TEST_F(WorkStealingDequeTest, ConcurrentOwnerAndThievesSeeEveryTaskOnce) {
+        WorkStealingDeque deque;
+        const int taskCount = 20000;
+        std::atomic<int> taken{ 0 };
+        std::atomic<bool> producing{ true };
+
+        std::vector<std::thread> thieves;
+        for (int i = 0; i < 3; i++) {
+            thieves.emplace_back([&deque, &taken, &producing]() {
+                while (producing || !deque.empty()) {
+                    if (deque.stealFront()) {
+                        taken++;
+                    }
+                }
+                });
+        }
+
+        for (int i = 0; i < taskCount; i++) {
+            deque.pushBack(createTask());
+            if (i % 3 == 0 && deque.popBack()) {
+                taken++;
+            }
+        }
+        producing = false;
+
+        for (auto& thief : thieves) {
+            thief.join();
+        }
+        while (deque.popBack()) {
+            taken++;
+        }
+
+        EXPECT_EQ(taken, taskCount);
+    }
+
+}  // namespace adapter::Tests
@@ -21,12 +21,18 @@
 #include <gmock/gmock.h>
 
 // FlowLock components
+#include "TagRegistry.h"
 #include "FlowTask.h"
 #include "FlowContext.h"
 #include "FlowScheduler.h"
+#include "WorkStealingDeque.h"
 #include "FlowExecution.h"
 #include "ConflictResolver.h"
 #include "ThreadPool.h"
+#include "TimingWheel.h"
 #include "FlowLock.h"
 #include "FlowTracer.h"
-#include "FlowSection.h"
\ No newline at end of file
+#include "FlowSection.h"
+#include "FlowGraph.h"
+#include "FlowBuilder.h"
+#include "FlowCoro.h"
\ No newline at end of file